@@ -2,36 +2,60 @@
 #define _GRAPH_CLASS_H_
 
 #include <cstddef>
+#include <algorithm>
 #include <utility>
 #include <optional>
 #include <vector>
-#include <unordered_set>
+#include <unordered_map>
 
 #include "./_graph_primitives.h"
+#include "./_graph_storage.h"
+#include "./_graph_parallel.h"
+#include "../heap/d_ary_heap.h"
+#include "../heap/radix_heap.h"
 
-template <bool dir, class Wei = void>
+template <class Weight>
+class ContractionHierarchy;
+template <class Cap>
+class FlowResult;
+template <class Wei>
+struct Biconnected;
+
+template <bool dir, class Wei = void, class Adj = AdjacencyLists<Wei>>
 class Graph {
-  std::vector<std::vector<Edge<Wei>>> adj_list_;
+  Adj adj_list_;
+
+  template <bool, class, class>
+  friend class Graph;
 
   // DEFAULT METHODS
  public:
   Graph() = default;
-  Graph(const Graph<dir, Wei>&) = default;
-  Graph(Graph<dir, Wei>&&) noexcept = default;
-  Graph<dir, Wei>& operator=(const Graph<dir, Wei>&) = default;
-  Graph<dir, Wei>& operator=(Graph<dir, Wei>&&) noexcept = default;
+  Graph(const Graph<dir, Wei, Adj>&) = default;
+  Graph(Graph<dir, Wei, Adj>&&) noexcept = default;
+  Graph<dir, Wei, Adj>& operator=(const Graph<dir, Wei, Adj>&) = default;
+  Graph<dir, Wei, Adj>& operator=(Graph<dir, Wei, Adj>&&) noexcept = default;
   ~Graph() = default;
 
   Graph(size_t);
   Graph(std::initializer_list<Edge<Wei>>);
+  Graph(size_t, const std::vector<Edge<Wei>>&);
+  template <class OtherAdj, std::enable_if_t<!std::is_same_v<Adj, OtherAdj>, int> = 0>
+  explicit Graph(const Graph<dir, Wei, OtherAdj>&);
   size_t Size() const;
-  Graph<dir, Wei> Transposed() const;
+  Graph<dir, Wei, Adj> Transposed() const;
   void AddVertex();
   template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   void AddEdge(Vertex, Vertex, Weight);
   template <class Weight = Wei, EnifNoWeight<Wei, Weight> = 0>
   void AddEdge(Vertex, Vertex);
 
+ private:
+  std::vector<size_t> ArcOffsets() const;
+  std::vector<Vertex> ArcHeads() const;
+  std::vector<size_t> ArcTwins(const std::vector<size_t>&, const std::vector<Vertex>&) const;
+  std::vector<Edge<Wei>> UndirectedEdges() const;
+
   // BFS
  public:
   std::vector<size_t> BFS(Vertex) const;
@@ -39,6 +63,19 @@ class Graph {
   std::vector<size_t> BFS_01(Vertex) const;
   template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   std::vector<size_t> BFS_0k(Vertex, size_t) const;
+  template <template <class> class Queue = RadixHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::vector<size_t> IntegerSSSP(Vertex) const;
+  std::vector<size_t> ParallelBFS(Vertex, size_t num_threads = detail::DefaultNumThreads()) const;
+  template <size_t kBatch = 64ul>
+  Matrix<size_t> MultiSourceBFS(const std::vector<Vertex>&) const;
+  template <size_t kBatch = 64ul>
+  std::vector<BFSStats> MultiSourceBFSStats(const std::vector<Vertex>&) const;
+
+ private:
+  template <size_t kWords, class Report>
+  void MultiSourceBFSBatch(const Vertex*, size_t, Report&&) const;
+  template <class Queue>
+  std::vector<size_t> BucketSSSP(Vertex, Queue&&) const;
 
   // DFS
  public:
@@ -47,11 +84,24 @@ class Graph {
   template <bool directed = dir, EnifDirected<dir, directed> = 0>
   std::pair<bool, std::vector<Vertex>> TopSort(bool do_reverse = true) const;
   std::vector<std::vector<Vertex>> SCC() const;
+  std::vector<size_t> SCCIds() const;
+  std::vector<size_t> ParallelSCC(size_t num_threads = detail::DefaultNumThreads()) const;
+  template <bool directed = dir, EnifDirected<dir, directed> = 0>
+  std::pair<Graph<true, Wei>, std::vector<size_t>> Condense() const;
 
  private:
-  void RecursiveDfsVisit(Vertex, DFStimes&, std::vector<Color>&, size_t&) const;
-  bool RecursiveHasCycle(Vertex, std::vector<Color>&, std::vector<Vertex>&) const;
-  bool RecursiveTopSort(Vertex, std::vector<Color>&, std::vector<Vertex>&) const;
+  using EdgeIterator = decltype(std::declval<const Adj&>()[Vertex{}].begin());
+  struct DfsFrame {
+    Vertex vertex;
+    EdgeIterator next;
+    EdgeIterator end;
+  };
+  DfsFrame MakeFrame(Vertex) const;
+  void DfsVisit(Vertex, DFStimes&, std::vector<Color>&, size_t&, std::vector<DfsFrame>&) const;
+  bool TopSortVisit(Vertex, std::vector<Color>&, std::vector<Vertex>&, std::vector<DfsFrame>&) const;
+  size_t TarjanSCC(std::vector<size_t>&, size_t) const;
+  template <class Incoming>
+  std::vector<size_t> ForwardBackwardTrim(const Incoming&, size_t) const;
 
   // Euler
  public:
@@ -60,45 +110,94 @@ class Graph {
   std::vector<Vertex> EulerPath() const;
   std::vector<Vertex> EulerCycle() const;
 
+ private:
+  std::vector<Vertex> Hierholzer(Vertex) const;
+
   // AP & bridges
  public:
   template <bool directed = dir, EnifUndirected<dir, directed> = 0>
   std::vector<Vertex> ArticulationPoints() const;
   template <bool directed = dir, EnifUndirected<dir, directed> = 0>
   std::vector<Edge<Wei>> Bridges() const;
-
- private:
-  void RecursiveAP(std::optional<Vertex>, Vertex, DFStimes&, std::vector<Color>&, std::vector<Vertex>&, size_t&) const;
-  void RecursiveBridges(std::optional<Vertex>, Vertex, DFStimes&, std::vector<Color>&, std::unordered_set<Edge<Wei>>&,
-                        size_t&) const;
+  template <bool directed = dir, EnifUndirected<dir, directed> = 0>
+  Biconnected<Wei> Biconnectivity() const;
 
   // MST
  public:
-  template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
-  std::vector<Edge<Weight>> Prim() const;
+  template <template <class> class Queue = QuaternaryHeap, bool directed = dir, class Weight = Wei,
+            EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::vector<Edge<Weight>> Prim(bool dense = false) const;
   template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
   std::vector<Edge<Weight>> Kruskal() const;
   template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::vector<Edge<Weight>> FilterKruskal() const;
+  template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::vector<Edge<Weight>> ParallelKruskal(size_t num_threads = detail::DefaultNumThreads()) const;
+  template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
   std::vector<Edge<Weight>> Boruvka() const;
+  template <bool directed = dir, class Weight = Wei, EnifUndirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::vector<Edge<Weight>> ParallelBoruvka(size_t num_threads = detail::DefaultNumThreads()) const;
 
   // Distance
  public:
-  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  template <template <class> class Queue = QuaternaryHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   std::vector<std::optional<Weight>> Dijkstra(Vertex) const;
+  template <template <class> class Queue = QuaternaryHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Path<Weight>> ShortestPath(Vertex, Vertex) const;
+  template <template <class> class Queue = QuaternaryHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Path<Weight>> BidirectionalShortestPath(Vertex, Vertex) const;
+  template <template <class> class Queue = QuaternaryHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Path<Weight>> BidirectionalShortestPath(Vertex, Vertex, const Graph<dir, Wei, Adj>&) const;
+  template <template <class> class Queue = QuaternaryHeap, class Heuristic, class Weight = Wei,
+            EnifWeighted<Wei, Weight> = 0>
+  std::optional<Path<Weight>> AStar(Vertex, Vertex, Heuristic&&) const;
+  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  ContractionHierarchy<Weight> BuildContractionHierarchy(size_t max_witness_settled = 500ul) const;
+  // delta is not deduced, so DeltaStepping(start, 3) works for any Wei
+  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<std::vector<std::optional<Weight>>> DeltaStepping(
+      Vertex, std::common_type_t<Weight> delta, size_t num_threads = detail::DefaultNumThreads()) const;
   template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   std::pair<bool, std::vector<Weight>> BellmanFord(Vertex) const;
   template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
-  std::optional<std::vector<std::vector<Weight>>> FloydWarshall() const;
+  std::pair<std::vector<std::optional<Weight>>, std::vector<Vertex>> SPFA(Vertex) const;
+  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Matrix<Weight>> FloydWarshall(size_t num_threads = detail::DefaultNumThreads()) const;
   template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   std::optional<std::vector<std::vector<std::optional<Weight>>>> Johnson() const;
+  template <template <class> class Queue = QuaternaryHeap, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Matrix<Weight>> JohnsonMatrix(size_t num_threads = detail::DefaultNumThreads()) const;
+  template <bool directed = dir, class Weight = Wei, EnifDirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::optional<std::vector<std::optional<Weight>>> DAGShortestPaths(Vertex) const;
+  template <bool directed = dir, class Weight = Wei, EnifDirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::optional<std::vector<std::optional<Weight>>> DAGLongestPaths(Vertex) const;
+  template <bool directed = dir, class Weight = Wei, EnifDirected<dir, directed> = 0, EnifWeighted<Wei, Weight> = 0>
+  std::optional<Path<Weight>> CriticalPath() const;
+
+ private:
+  template <template <class> class Queue, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  void DijkstraRow(Vertex, Weight*, Queue<Weight>&, std::vector<size_t>&) const;
+  template <class Weight, class Compare>
+  std::optional<std::vector<std::optional<Weight>>> DAGPaths(Vertex, Compare) const;
 
   // Flows
+ public:
   template <bool directed = dir, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   Weight FordFulkerson(Vertex, Vertex) const;
   template <bool directed = dir, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
   Weight EdmondsKarp(Vertex, Vertex) const;
   template <bool directed = dir, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
-  Weight Dinic(Vertex, Vertex) const;
+  Weight Dinic(Vertex, Vertex, bool capacity_scaling = false) const;
+  template <bool directed = dir, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::pair<Weight, std::vector<bool>> PushRelabel(Vertex, Vertex) const;
+  template <bool directed = dir, class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  FlowResult<Weight> MaxFlow(Vertex, Vertex) const;
+  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::optional<std::pair<typename Weight::CapacityType, typename Weight::CostType>> MinCostMaxFlow(Vertex,
+                                                                                                     Vertex) const;
+  template <class Weight = Wei, EnifWeighted<Wei, Weight> = 0>
+  std::pair<typename Weight::CapacityType, typename Weight::CostType> MinCostMaxFlowCostScaling(Vertex,
+                                                                                                 Vertex) const;
 
  private:
   bool RecursiveDFSFordFulkerson(Vertex, Vertex, std::vector<std::unordered_map<Vertex, std::pair<Wei, Wei>>>&,
@@ -110,12 +209,12 @@ class Graph {
 ////  METHODS  ////
 ///////////////////
 
-template <bool dir, class Wei>
-Graph<dir, Wei>::Graph(size_t n) : adj_list_(n) {
+template <bool dir, class Wei, class Adj>
+Graph<dir, Wei, Adj>::Graph(size_t n) : adj_list_(n) {
 }
 
-template <bool dir, class Wei>
-Graph<dir, Wei>::Graph(std::initializer_list<Edge<Wei>> list_edges) : adj_list_{} {
+template <bool dir, class Wei, class Adj>
+Graph<dir, Wei, Adj>::Graph(std::initializer_list<Edge<Wei>> list_edges) : adj_list_{} {
   Vertex max_vertex = 0;
   for (const auto& edge : list_edges) {
     if (max_vertex < edge.src) {
@@ -125,59 +224,175 @@ Graph<dir, Wei>::Graph(std::initializer_list<Edge<Wei>> list_edges) : adj_list_{
       max_vertex = edge.dst;
     }
   }
-  adj_list_.resize(max_vertex + 1);
-  for (const auto& edge : list_edges) {
-    adj_list_[edge.src].emplace_back(edge);
-    if constexpr (!dir && std::is_same_v<Wei, void>) {
-      adj_list_[edge.dst].emplace_back(edge.dst, edge.src);
-    }
-    if constexpr (!dir && !std::is_same_v<Wei, void>) {
-      adj_list_[edge.dst].emplace_back(edge.dst, edge.src, edge.weight);
+  *this = Graph<dir, Wei, Adj>(max_vertex + 1, std::vector<Edge<Wei>>(list_edges.begin(), list_edges.end()));
+}
+
+template <bool dir, class Wei, class Adj>
+Graph<dir, Wei, Adj>::Graph(size_t n, const std::vector<Edge<Wei>>& edges) : adj_list_{} {
+  if constexpr (dir) {
+    adj_list_ = Adj(n, edges);
+  } else {
+    std::vector<Edge<Wei>> arcs;
+    arcs.reserve(2 * edges.size());
+    for (const auto& edge : edges) {
+      arcs.emplace_back(edge);
+      if constexpr (std::is_same_v<Wei, void>) {
+        arcs.emplace_back(edge.dst, edge.src);
+      } else {
+        arcs.emplace_back(edge.dst, edge.src, edge.weight);
+      }
     }
+    adj_list_ = Adj(n, arcs);
   }
 }
 
-template <bool dir, class Wei>
-size_t Graph<dir, Wei>::Size() const {
+template <bool dir, class Wei, class Adj>
+template <class OtherAdj, std::enable_if_t<!std::is_same_v<Adj, OtherAdj>, int>>
+Graph<dir, Wei, Adj>::Graph(const Graph<dir, Wei, OtherAdj>& other) : adj_list_(other.adj_list_) {
+}
+
+template <bool dir, class Wei, class Adj>
+size_t Graph<dir, Wei, Adj>::Size() const {
   return adj_list_.size();
 }
 
-template <bool dir, class Wei>
-Graph<dir, Wei> Graph<dir, Wei>::Transposed() const {
-  Graph<dir, Wei> graph{adj_list_.size()};
-  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-    for (const auto& edge : adj_list_[vertex]) {
+template <bool dir, class Wei, class Adj>
+Graph<dir, Wei, Adj> Graph<dir, Wei, Adj>::Transposed() const {
+  std::vector<Edge<Wei>> arcs;
+  for (const auto& curr_edges : adj_list_) {
+    for (const auto& edge : curr_edges) {
       if constexpr (std::is_same_v<Wei, void>) {
-        graph.adj_list_[edge.dst].emplace_back(edge.dst, edge.src);
+        arcs.emplace_back(edge.dst, edge.src);
       } else {
-        graph.adj_list_[edge.dst].emplace_back(edge.dst, edge.src, edge.weight);
+        arcs.emplace_back(edge.dst, edge.src, edge.weight);
       }
     }
   }
+  Graph<dir, Wei, Adj> graph;
+  graph.adj_list_ = Adj(adj_list_.size(), arcs);
   return graph;
 }
 
-template <bool dir, class Wei>
-void Graph<dir, Wei>::AddVertex() {
-  adj_list_.emplace_back();
+template <bool dir, class Wei, class Adj>
+void Graph<dir, Wei, Adj>::AddVertex() {
+  adj_list_.AddVertex();
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <class Weight, EnifNoWeight<Wei, Weight>>
-void Graph<dir, Wei>::AddEdge(Vertex src, Vertex dst) {
-  adj_list_[src].emplace_back(src, dst);
+void Graph<dir, Wei, Adj>::AddEdge(Vertex src, Vertex dst) {
+  adj_list_.AddArc(src, {src, dst});
   if constexpr (!dir) {
-    adj_list_[dst].emplace_back(dst, src);
+    adj_list_.AddArc(dst, {dst, src});
   }
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <class Weight, EnifWeighted<Wei, Weight>>
-void Graph<dir, Wei>::AddEdge(Vertex src, Vertex dst, Weight weight) {
-  adj_list_[src].emplace_back(src, dst, weight);
+void Graph<dir, Wei, Adj>::AddEdge(Vertex src, Vertex dst, Weight weight) {
+  adj_list_.AddArc(src, {src, dst, weight});
   if constexpr (!dir) {
-    adj_list_[dst].emplace_back(dst, src, weight);
+    adj_list_.AddArc(dst, {dst, src, weight});
+  }
+}
+
+// Flat arc numbering: arcs of vertex v are [offsets[v], offsets[v + 1])
+// in adjacency order
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::ArcOffsets() const {
+  std::vector<size_t> offsets(adj_list_.size() + 1, 0ul);
+  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+    offsets[vertex + 1] = offsets[vertex] + adj_list_[vertex].size();
+  }
+  return offsets;
+}
+
+template <bool dir, class Wei, class Adj>
+std::vector<Vertex> Graph<dir, Wei, Adj>::ArcHeads() const {
+  std::vector<Vertex> head;
+  for (const auto& curr_edges : adj_list_) {
+    for (const auto& edge : curr_edges) {
+      head.emplace_back(edge.dst);
+    }
+  }
+  return head;
+}
+
+// Pairs the two stored copies of every undirected edge in O(V + E): a
+// two-pass counting sort groups arcs by their (min, max) endpoints, then
+// copies stored at the smaller endpoint pair up in order with those stored
+// at the larger one, and the two copies of a loop are adjacent.
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::ArcTwins(const std::vector<size_t>& offsets,
+                                                   const std::vector<Vertex>& head) const {
+  const size_t num_vertices = adj_list_.size();
+  const size_t num_arcs = head.size();
+  std::vector<Vertex> source(num_arcs);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    std::fill(source.begin() + offsets[vertex], source.begin() + offsets[vertex + 1], vertex);
+  }
+  auto low = [&](size_t arc) { return std::min(source[arc], head[arc]); };
+  auto high = [&](size_t arc) { return std::max(source[arc], head[arc]); };
+  auto counting_sort = [num_vertices](const std::vector<size_t>& arcs, auto key) {
+    std::vector<size_t> count(num_vertices + 1, 0ul);
+    for (size_t arc : arcs) {
+      ++count[key(arc) + 1];
+    }
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      count[vertex + 1] += count[vertex];
+    }
+    std::vector<size_t> sorted(arcs.size());
+    for (size_t arc : arcs) {
+      sorted[count[key(arc)]++] = arc;
+    }
+    return sorted;
+  };
+  std::vector<size_t> arcs(num_arcs);
+  for (size_t arc = 0; arc < num_arcs; ++arc) {
+    arcs[arc] = arc;
+  }
+  arcs = counting_sort(arcs, high);
+  arcs = counting_sort(arcs, low);
+
+  std::vector<size_t> twin(num_arcs);
+  std::vector<size_t> lower;
+  std::vector<size_t> upper;
+  for (size_t begin = 0, end = 0; begin < num_arcs; begin = end) {
+    Vertex lo = low(arcs[begin]);
+    Vertex hi = high(arcs[begin]);
+    lower.clear();
+    upper.clear();
+    for (end = begin; end < num_arcs && low(arcs[end]) == lo && high(arcs[end]) == hi; ++end) {
+      (source[arcs[end]] == lo ? lower : upper).emplace_back(arcs[end]);
+    }
+    if (lo == hi) {
+      for (size_t index = 0; index + 1 < lower.size(); index += 2) {
+        twin[lower[index]] = lower[index + 1];
+        twin[lower[index + 1]] = lower[index];
+      }
+    } else {
+      for (size_t index = 0; index < lower.size(); ++index) {
+        twin[lower[index]] = upper[index];
+        twin[upper[index]] = lower[index];
+      }
+    }
+  }
+  return twin;
+}
+
+// Every undirected edge once, as its copy with src < dst; self-loops
+// are left out
+template <bool dir, class Wei, class Adj>
+std::vector<Edge<Wei>> Graph<dir, Wei, Adj>::UndirectedEdges() const {
+  std::vector<Edge<Wei>> edges;
+  for (const auto& curr_edges : adj_list_) {
+    for (const auto& edge : curr_edges) {
+      if (edge.src < edge.dst) {
+        edges.emplace_back(edge);
+      }
+    }
   }
+  return edges;
 }
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef _GRAPH_MIN_PLUS_H_
+#define _GRAPH_MIN_PLUS_H_
+
+#include <cstddef>
+#include <type_traits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace detail {
+
+// row[j] = min(row[j], add + other[j]) for j < size.
+// AVX2 paths for 32/64-bit signed integers, float and double, the scalar
+// tail handles the rest and every other weight type.
+template <class T>
+void MinPlusRow(T* row, T add, const T* other, size_t size) {
+  size_t j = 0;
+#ifdef __AVX2__
+  if constexpr (std::is_same_v<T, float>) {
+    __m256 add_v = _mm256_set1_ps(add);
+    for (; j + 8 <= size; j += 8) {
+      __m256 candidate = _mm256_add_ps(add_v, _mm256_loadu_ps(other + j));
+      _mm256_storeu_ps(row + j, _mm256_min_ps(_mm256_loadu_ps(row + j), candidate));
+    }
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m256d add_v = _mm256_set1_pd(add);
+    for (; j + 4 <= size; j += 4) {
+      __m256d candidate = _mm256_add_pd(add_v, _mm256_loadu_pd(other + j));
+      _mm256_storeu_pd(row + j, _mm256_min_pd(_mm256_loadu_pd(row + j), candidate));
+    }
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4) {
+    __m256i add_v = _mm256_set1_epi32(add);
+    for (; j + 8 <= size; j += 8) {
+      auto* row_v = reinterpret_cast<__m256i*>(row + j);
+      __m256i candidate = _mm256_add_epi32(add_v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other + j)));
+      _mm256_storeu_si256(row_v, _mm256_min_epi32(_mm256_loadu_si256(row_v), candidate));
+    }
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8) {
+    // No 64-bit min before AVX-512: compare and blend
+    __m256i add_v = _mm256_set1_epi64x(add);
+    for (; j + 4 <= size; j += 4) {
+      auto* row_v = reinterpret_cast<__m256i*>(row + j);
+      __m256i current = _mm256_loadu_si256(row_v);
+      __m256i candidate = _mm256_add_epi64(add_v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other + j)));
+      __m256i greater = _mm256_cmpgt_epi64(current, candidate);
+      _mm256_storeu_si256(row_v, _mm256_blendv_epi8(current, candidate, greater));
+    }
+  }
+#endif
+  // Branch-free so that the compiler can still vectorize it
+  for (; j < size; ++j) {
+    T candidate = add + other[j];
+    row[j] = candidate < row[j] ? candidate : row[j];
+  }
+}
+
+// One Floyd-Warshall round over a block x block tile: relaxes tile c
+// through the pivot rows of tile b and pivot columns of tile a. The tiles
+// live in one matrix with row length `stride` and may alias each other.
+template <class T>
+void MinPlusTile(T* c, const T* a, const T* b, size_t stride, size_t block, T inf) {
+  for (size_t k = 0; k < block; ++k) {
+    const T* pivot_row = b + k * stride;
+    for (size_t i = 0; i < block; ++i) {
+      T through = a[i * stride + k];
+      if (through != inf) {
+        MinPlusRow(c + i * stride, through, pivot_row, block);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+#endif
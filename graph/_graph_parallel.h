@@ -0,0 +1,160 @@
+#ifndef _GRAPH_PARALLEL_H_
+#define _GRAPH_PARALLEL_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace detail {
+
+inline size_t DefaultNumThreads() {
+  size_t num_threads = std::thread::hardware_concurrency();
+  return num_threads ? num_threads : 1ul;
+}
+
+// Splits [0, size) into chunks of `grain` indices and hands them out to
+// `num_threads` workers. Calls func(thread_id, chunk_begin, chunk_end).
+// Runs inline on the calling thread when there is not enough work.
+template <class Func>
+void ParallelFor(size_t size, size_t num_threads, Func&& func, size_t grain = 1024ul) {
+  grain = std::max(grain, 1ul);
+  size_t num_chunks = (size + grain - 1) / grain;
+  num_threads = std::min(num_threads, num_chunks);
+  if (num_threads <= 1ul) {
+    if (size) {
+      func(0ul, 0ul, size);
+    }
+    return;
+  }
+  std::atomic<size_t> next_chunk{0ul};
+  auto worker = [&](size_t thread_id) {
+    for (size_t chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+      func(thread_id, chunk * grain, std::min(size, (chunk + 1) * grain));
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t thread_id = 1; thread_id < num_threads; ++thread_id) {
+    threads.emplace_back(worker, thread_id);
+  }
+  worker(0ul);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Persistent workers for algorithms that run many short parallel phases,
+// where spawning threads in every ParallelFor would dominate.
+// Run() has the same contract as ParallelFor, thread ids are < NumThreads().
+class ThreadPool {
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  std::function<void(size_t, size_t, size_t)> job_;
+  std::atomic<size_t> next_chunk_{0ul};
+  size_t size_{0ul};
+  size_t grain_{1ul};
+  size_t num_chunks_{0ul};
+  size_t generation_{0ul};
+  size_t busy_{0ul};
+  bool stop_{false};
+
+ public:
+  explicit ThreadPool(size_t num_threads = DefaultNumThreads());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  size_t NumThreads() const;
+  template <class Func>
+  void Run(size_t, Func&&, size_t grain = 1024ul);
+
+ private:
+  void RunChunks(size_t);
+  void WorkerLoop(size_t);
+};
+
+inline ThreadPool::ThreadPool(size_t num_threads) {
+  num_threads = std::max(num_threads, 1ul);
+  workers_.reserve(num_threads - 1);
+  for (size_t thread_id = 1; thread_id < num_threads; ++thread_id) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, thread_id);
+  }
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+inline size_t ThreadPool::NumThreads() const {
+  return workers_.size() + 1;
+}
+
+template <class Func>
+void ThreadPool::Run(size_t size, Func&& func, size_t grain) {
+  grain = std::max(grain, 1ul);
+  size_t num_chunks = (size + grain - 1) / grain;
+  if (workers_.empty() || num_chunks <= 1ul) {
+    if (size) {
+      func(0ul, 0ul, size);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = std::ref(func);
+    size_ = size;
+    grain_ = grain;
+    num_chunks_ = num_chunks;
+    next_chunk_ = 0ul;
+    busy_ = workers_.size();
+    ++generation_;
+  }
+  start_.notify_all();
+  RunChunks(0ul);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0ul; });
+  job_ = nullptr;
+}
+
+inline void ThreadPool::RunChunks(size_t thread_id) {
+  for (size_t chunk = next_chunk_++; chunk < num_chunks_; chunk = next_chunk_++) {
+    job_(thread_id, chunk * grain_, std::min(size_, (chunk + 1) * grain_));
+  }
+}
+
+inline void ThreadPool::WorkerLoop(size_t thread_id) {
+  size_t seen_generation = 0ul;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+      if (stop_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+    RunChunks(thread_id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_ == 0ul) {
+      done_.notify_one();
+    }
+  }
+}
+
+}  // namespace detail
+
+#endif
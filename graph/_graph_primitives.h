@@ -19,6 +19,78 @@ using EnifWeighted = std::enable_if_t<std::is_same_v<Wei, Weight> && !std::is_sa
 template <class Wei, class Weight>
 using EnifNoWeight = std::enable_if_t<std::is_same_v<Wei, Weight> && std::is_same_v<Weight, void>, int>;
 
+// Dense row-major matrix in one contiguous buffer
+template <class T>
+class Matrix {
+  size_t rows_{0ul};
+  size_t cols_{0ul};
+  std::vector<T> data_{};
+
+ public:
+  Matrix() = default;
+  Matrix(size_t rows, size_t cols, const T& value = T{}) : rows_{rows}, cols_{cols}, data_(rows * cols, value) {
+  }
+
+  size_t Rows() const {
+    return rows_;
+  }
+  size_t Cols() const {
+    return cols_;
+  }
+  T* operator[](size_t row) {
+    return data_.data() + row * cols_;
+  }
+  const T* operator[](size_t row) const {
+    return data_.data() + row * cols_;
+  }
+  T* Data() {
+    return data_.data();
+  }
+  const T* Data() const {
+    return data_.data();
+  }
+};
+
+template <class Weight>
+struct Path {
+  Weight length;
+  std::vector<Vertex> vertices;  // from source to target inclusive
+  size_t num_settled;            // vertices extracted from the queue(s)
+};
+
+// Aggregates of one unweighted BFS over the vertices it reached, the
+// source included
+struct BFSStats {
+  size_t eccentricity{0ul};
+  size_t reached{0ul};
+  size_t distance_sum{0ul};
+
+  // (reached - 1) / distance_sum, zero when nothing else is reachable
+  double Closeness() const {
+    return distance_sum ? static_cast<double>(reached - 1) / static_cast<double>(distance_sum) : 0.0;
+  }
+};
+
+// Edge weight for min-cost flow: Graph<true, CapacityCost<Cap, Cost>>
+template <class Cap, class Cost>
+struct CapacityCost {
+  using CapacityType = Cap;
+  using CostType = Cost;
+
+  Cap capacity{};
+  Cost cost{};
+};
+
+template <class Cap, class Cost>
+bool operator==(const CapacityCost<Cap, Cost>& lhs, const CapacityCost<Cap, Cost>& rhs) {
+  return (lhs.capacity == rhs.capacity) && (lhs.cost == rhs.cost);
+}
+
+template <class Cap, class Cost>
+std::ostream& operator<<(std::ostream& os, const CapacityCost<Cap, Cost>& weight) {
+  return os << weight.capacity << " $" << weight.cost;
+}
+
 template <class Weight = void>
 struct Edge {
   Vertex src;
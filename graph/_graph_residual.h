@@ -0,0 +1,79 @@
+#ifndef _GRAPH_RESIDUAL_H_
+#define _GRAPH_RESIDUAL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "./_graph_primitives.h"
+
+namespace detail {
+
+// Residual network shared by the flow algorithms. Arcs of vertex v are
+// [offsets[v], offsets[v + 1]), arc a goes to head[a] with residual[a]
+// capacity left and reverse[a] is the index of its paired arc.
+// Every input arc src -> dst yields a forward arc with its capacity and a
+// reverse arc with zero capacity; forward[i] is the forward arc of the
+// i-th input arc in adjacency order.
+template <class Cap>
+struct ResidualNetwork {
+  std::vector<size_t> offsets;
+  std::vector<Vertex> head;
+  std::vector<Cap> residual;
+  std::vector<size_t> reverse;
+  std::vector<size_t> forward;
+
+  ResidualNetwork() = default;
+  // capacity(edge) extracts the capacity from an adjacency row entry
+  template <class Adj, class CapacityOf>
+  ResidualNetwork(const Adj&, CapacityOf&&);
+
+  size_t NumVertices() const {
+    return offsets.size() - 1;
+  }
+  size_t NumArcs() const {
+    return head.size();
+  }
+  // Pushes delta units along arc
+  void Push(size_t arc, Cap delta) {
+    residual[arc] -= delta;
+    residual[reverse[arc]] += delta;
+  }
+};
+
+template <class Cap>
+template <class Adj, class CapacityOf>
+ResidualNetwork<Cap>::ResidualNetwork(const Adj& adj, CapacityOf&& capacity) : offsets(adj.size() + 1, 0ul) {
+  size_t num_input = 0;
+  for (Vertex vertex = 0; vertex < adj.size(); ++vertex) {
+    for (const auto& edge : adj[vertex]) {
+      ++offsets[vertex + 1];
+      ++offsets[edge.dst + 1];
+      ++num_input;
+    }
+  }
+  for (Vertex vertex = 0; vertex < adj.size(); ++vertex) {
+    offsets[vertex + 1] += offsets[vertex];
+  }
+  head.resize(2 * num_input);
+  residual.resize(2 * num_input);
+  reverse.resize(2 * num_input);
+  forward.reserve(num_input);
+  std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+  for (Vertex vertex = 0; vertex < adj.size(); ++vertex) {
+    for (const auto& edge : adj[vertex]) {
+      size_t arc = position[vertex]++;
+      size_t back = position[edge.dst]++;
+      head[arc] = edge.dst;
+      head[back] = vertex;
+      residual[arc] = capacity(edge);
+      residual[back] = Cap{};
+      reverse[arc] = back;
+      reverse[back] = arc;
+      forward.emplace_back(arc);
+    }
+  }
+}
+
+}  // namespace detail
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef _GRAPH_SORT_H_
+#define _GRAPH_SORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "./_graph_parallel.h"
+
+namespace detail {
+
+// Stable LSD radix sort of items by an integral key(item), one byte per
+// pass. Every thread owns one contiguous block: it counts the digits of
+// its block, and after a prefix sum over (digit, block) it scatters the
+// block into its own output ranges. Bytes in which all keys agree are
+// skipped.
+template <class T, class KeyOf>
+void ParallelRadixSort(std::vector<T>& items, KeyOf&& key_of, size_t num_threads) {
+  using Key = std::decay_t<decltype(key_of(items.front()))>;
+  using Unsigned = std::make_unsigned_t<Key>;
+  constexpr size_t kRadix = 256ul;
+  // Flipping the sign bit orders signed keys as unsigned
+  constexpr Unsigned kFlip = std::is_signed_v<Key> ? Unsigned{1} << (8 * sizeof(Key) - 1) : Unsigned{0};
+  const size_t size = items.size();
+  if (size < 2) {
+    return;
+  }
+  auto digits = [&](const T& item) { return static_cast<Unsigned>(key_of(item)) ^ kFlip; };
+
+  num_threads = std::max(std::min(num_threads, size / 4096 + 1), 1ul);
+  const size_t block = (size + num_threads - 1) / num_threads;
+  const size_t num_blocks = (size + block - 1) / block;
+
+  std::vector<Unsigned> differ(num_blocks, 0);
+  const Unsigned first = digits(items.front());
+  ParallelFor(
+      size, num_threads,
+      [&](size_t, size_t begin, size_t end) {
+        Unsigned local = 0;
+        for (size_t index = begin; index < end; ++index) {
+          local |= digits(items[index]) ^ first;
+        }
+        differ[begin / block] = local;
+      },
+      block);
+  Unsigned mask = 0;
+  for (Unsigned local : differ) {
+    mask |= local;
+  }
+
+  std::vector<T> buffer(size, items.front());
+  std::vector<size_t> count(num_blocks * kRadix);
+  for (size_t shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+    if (((mask >> shift) & 0xFF) == 0) {
+      continue;
+    }
+    std::fill(count.begin(), count.end(), 0ul);
+    ParallelFor(
+        size, num_threads,
+        [&](size_t, size_t begin, size_t end) {
+          size_t* local = count.data() + (begin / block) * kRadix;
+          for (size_t index = begin; index < end; ++index) {
+            ++local[(digits(items[index]) >> shift) & 0xFF];
+          }
+        },
+        block);
+    size_t total = 0ul;
+    for (size_t digit = 0; digit < kRadix; ++digit) {
+      for (size_t part = 0; part < num_blocks; ++part) {
+        size_t curr = count[part * kRadix + digit];
+        count[part * kRadix + digit] = total;
+        total += curr;
+      }
+    }
+    ParallelFor(
+        size, num_threads,
+        [&](size_t, size_t begin, size_t end) {
+          size_t* local = count.data() + (begin / block) * kRadix;
+          for (size_t index = begin; index < end; ++index) {
+            buffer[local[(digits(items[index]) >> shift) & 0xFF]++] = items[index];
+          }
+        },
+        block);
+    items.swap(buffer);
+  }
+}
+
+// Sorts one block per thread with std::sort, then merges pairs of runs
+// in parallel until one run is left
+template <class T, class Less>
+void ParallelSort(std::vector<T>& items, Less&& less, size_t num_threads) {
+  const size_t size = items.size();
+  num_threads = std::max(std::min(num_threads, size / 4096 + 1), 1ul);
+  if (num_threads == 1) {
+    std::sort(items.begin(), items.end(), less);
+    return;
+  }
+  size_t run = (size + num_threads - 1) / num_threads;
+  ParallelFor(
+      size, num_threads,
+      [&](size_t, size_t begin, size_t end) { std::sort(items.begin() + begin, items.begin() + end, less); }, run);
+  if (run >= size) {
+    return;
+  }
+  std::vector<T> buffer(size, items.front());
+  for (; run < size; run *= 2) {
+    size_t num_pairs = (size + 2 * run - 1) / (2 * run);
+    ParallelFor(
+        num_pairs, num_threads,
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t pair = begin; pair < end; ++pair) {
+            size_t left = pair * 2 * run;
+            size_t middle = std::min(left + run, size);
+            size_t right = std::min(left + 2 * run, size);
+            std::merge(items.begin() + left, items.begin() + middle, items.begin() + middle, items.begin() + right,
+                       buffer.begin() + left, less);
+          }
+        },
+        1ul);
+    items.swap(buffer);
+  }
+}
+
+}  // namespace detail
+
+#endif
@@ -0,0 +1,527 @@
+#ifndef _GRAPH_STORAGE_H_
+#define _GRAPH_STORAGE_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./_graph_primitives.h"
+
+// Adjacency storages for Graph<dir, Wei, Adj>.
+// Every storage provides:
+//   size()            - number of vertices
+//   operator[](v)     - iterable row of Edge<Wei> with size()/empty()
+//   begin() / end()   - iteration over rows
+//   Storage(n, arcs)  - construction from a list of directed arcs
+//   Storage(other)    - construction from any other storage
+// Mutable storages additionally provide AddVertex() and AddArc(src, edge).
+
+/////////////////////////////
+////  ADJACENCY  LISTS   ////
+/////////////////////////////
+
+template <class Wei>
+class AdjacencyLists {
+  std::vector<std::vector<Edge<Wei>>> lists_;
+
+ public:
+  using Row = std::vector<Edge<Wei>>;
+  using RowIterator = typename std::vector<Row>::const_iterator;
+
+  AdjacencyLists() = default;
+  explicit AdjacencyLists(size_t);
+  AdjacencyLists(size_t, const std::vector<Edge<Wei>>&);
+  template <class Other, std::enable_if_t<!std::is_same_v<Other, AdjacencyLists<Wei>>, int> = 0>
+  explicit AdjacencyLists(const Other&);
+
+  size_t size() const;
+  const Row& operator[](Vertex) const;
+  RowIterator begin() const;
+  RowIterator end() const;
+
+  void AddVertex();
+  void AddArc(Vertex, const Edge<Wei>&);
+};
+
+template <class Wei>
+AdjacencyLists<Wei>::AdjacencyLists(size_t n) : lists_(n) {
+}
+
+template <class Wei>
+AdjacencyLists<Wei>::AdjacencyLists(size_t n, const std::vector<Edge<Wei>>& arcs) : lists_(n) {
+  for (const auto& arc : arcs) {
+    lists_[arc.src].emplace_back(arc);
+  }
+}
+
+template <class Wei>
+template <class Other, std::enable_if_t<!std::is_same_v<Other, AdjacencyLists<Wei>>, int>>
+AdjacencyLists<Wei>::AdjacencyLists(const Other& other) : lists_(other.size()) {
+  for (Vertex vertex = 0; vertex < other.size(); ++vertex) {
+    const auto& row = other[vertex];
+    lists_[vertex].reserve(row.size());
+    for (const auto& edge : row) {
+      lists_[vertex].emplace_back(edge);
+    }
+  }
+}
+
+template <class Wei>
+size_t AdjacencyLists<Wei>::size() const {
+  return lists_.size();
+}
+
+template <class Wei>
+auto AdjacencyLists<Wei>::operator[](Vertex vertex) const -> const Row& {
+  return lists_[vertex];
+}
+
+template <class Wei>
+auto AdjacencyLists<Wei>::begin() const -> RowIterator {
+  return lists_.begin();
+}
+
+template <class Wei>
+auto AdjacencyLists<Wei>::end() const -> RowIterator {
+  return lists_.end();
+}
+
+template <class Wei>
+void AdjacencyLists<Wei>::AddVertex() {
+  lists_.emplace_back();
+}
+
+template <class Wei>
+void AdjacencyLists<Wei>::AddArc(Vertex src, const Edge<Wei>& edge) {
+  lists_[src].emplace_back(edge);
+}
+
+/////////////////////////////
+////   ARENA ADJACENCY   ////
+/////////////////////////////
+
+// Mutable adjacency in one arc buffer instead of one vector per vertex.
+// Every vertex owns a block of the buffer with a power of two capacity
+// (or none), the first `size` slots used. A full block grows in place when
+// it is the last one, otherwise it moves to a block of twice the capacity,
+// at least kMinCapacity: a freed one of that size if there is one, else a
+// new one at the end. Freed blocks of kMinCapacity and up are kept in
+// per-size free lists for later moves, smaller ones are left unused. The
+// buffer is never compacted.
+// Prefer it (ArenaGraph) to AdjacencyLists for graphs of about 10^4
+// vertices and up that grow arc by arc. Below that, regrowing the one big
+// buffer costs more than the per-vertex allocations it saves. Graphs that
+// do not change once built are best stored in CSRAdjacency.
+template <class Wei>
+class ArenaAdjacency {
+  struct Block {
+    size_t begin;
+    size_t size;
+    size_t capacity;
+  };
+
+  std::vector<Edge<Wei>> arcs_{};
+  std::vector<Block> blocks_{};
+  std::vector<std::vector<size_t>> free_{};  // begins of freed blocks by log2 of capacity
+
+  static constexpr size_t kMinCapacity = 4ul;
+
+ public:
+  class Row;
+  class RowIterator;
+
+  ArenaAdjacency() = default;
+  explicit ArenaAdjacency(size_t);
+  ArenaAdjacency(size_t, const std::vector<Edge<Wei>>&);
+  template <class Other, std::enable_if_t<!std::is_same_v<Other, ArenaAdjacency<Wei>>, int> = 0>
+  explicit ArenaAdjacency(const Other&);
+
+  size_t size() const;
+  Row operator[](Vertex) const;
+  RowIterator begin() const;
+  RowIterator end() const;
+
+  void AddVertex();
+  void AddArc(Vertex, const Edge<Wei>&);
+
+ private:
+  static Edge<Wei> Filler();
+  static size_t Log2(size_t);
+  static size_t Capacity(size_t);
+  void Grow(Vertex);
+};
+
+template <class Wei>
+class ArenaAdjacency<Wei>::Row {
+  const Edge<Wei>* begin_;
+  const Edge<Wei>* end_;
+
+ public:
+  Row(const Edge<Wei>* begin, const Edge<Wei>* end) : begin_{begin}, end_{end} {
+  }
+  const Edge<Wei>* begin() const {
+    return begin_;
+  }
+  const Edge<Wei>* end() const {
+    return end_;
+  }
+  size_t size() const {
+    return static_cast<size_t>(end_ - begin_);
+  }
+  bool empty() const {
+    return begin_ == end_;
+  }
+};
+
+template <class Wei>
+class ArenaAdjacency<Wei>::RowIterator {
+  const ArenaAdjacency<Wei>* storage_;
+  Vertex vertex_;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Row;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = Row;
+
+  RowIterator(const ArenaAdjacency<Wei>* storage, Vertex vertex) : storage_{storage}, vertex_{vertex} {
+  }
+  Row operator*() const {
+    return (*storage_)[vertex_];
+  }
+  RowIterator& operator++() {
+    ++vertex_;
+    return *this;
+  }
+  bool operator==(const RowIterator& other) const {
+    return vertex_ == other.vertex_;
+  }
+  bool operator!=(const RowIterator& other) const {
+    return vertex_ != other.vertex_;
+  }
+};
+
+template <class Wei>
+ArenaAdjacency<Wei>::ArenaAdjacency(size_t n) : blocks_(n, Block{0ul, 0ul, 0ul}) {
+}
+
+template <class Wei>
+ArenaAdjacency<Wei>::ArenaAdjacency(size_t n, const std::vector<Edge<Wei>>& arcs) : blocks_(n, Block{0ul, 0ul, 0ul}) {
+  for (const auto& arc : arcs) {
+    ++blocks_[arc.src].capacity;
+  }
+  size_t begin = 0ul;
+  for (auto& block : blocks_) {
+    block.begin = begin;
+    block.capacity = Capacity(block.capacity);
+    begin += block.capacity;
+  }
+  arcs_.assign(begin, Filler());
+  for (const auto& arc : arcs) {
+    Block& block = blocks_[arc.src];
+    arcs_[block.begin + block.size++] = arc;
+  }
+}
+
+template <class Wei>
+template <class Other, std::enable_if_t<!std::is_same_v<Other, ArenaAdjacency<Wei>>, int>>
+ArenaAdjacency<Wei>::ArenaAdjacency(const Other& other) : blocks_(other.size(), Block{0ul, 0ul, 0ul}) {
+  for (Vertex vertex = 0; vertex < other.size(); ++vertex) {
+    Block& block = blocks_[vertex];
+    block.begin = arcs_.size();
+    for (const auto& edge : other[vertex]) {
+      arcs_.emplace_back(edge);
+    }
+    block.size = arcs_.size() - block.begin;
+    block.capacity = Capacity(block.size);
+    arcs_.resize(block.begin + block.capacity, Filler());
+  }
+}
+
+template <class Wei>
+size_t ArenaAdjacency<Wei>::size() const {
+  return blocks_.size();
+}
+
+template <class Wei>
+auto ArenaAdjacency<Wei>::operator[](Vertex vertex) const -> Row {
+  const Edge<Wei>* begin = arcs_.data() + blocks_[vertex].begin;
+  return Row(begin, begin + blocks_[vertex].size);
+}
+
+template <class Wei>
+auto ArenaAdjacency<Wei>::begin() const -> RowIterator {
+  return RowIterator(this, 0ul);
+}
+
+template <class Wei>
+auto ArenaAdjacency<Wei>::end() const -> RowIterator {
+  return RowIterator(this, size());
+}
+
+template <class Wei>
+void ArenaAdjacency<Wei>::AddVertex() {
+  blocks_.push_back({arcs_.size(), 0ul, 0ul});
+}
+
+template <class Wei>
+void ArenaAdjacency<Wei>::AddArc(Vertex src, const Edge<Wei>& edge) {
+  if (blocks_[src].size == blocks_[src].capacity) {
+    Grow(src);
+  }
+  Block& block = blocks_[src];
+  arcs_[block.begin + block.size++] = edge;
+}
+
+// Placeholder for slots that are reserved but not used yet
+template <class Wei>
+Edge<Wei> ArenaAdjacency<Wei>::Filler() {
+  if constexpr (std::is_same_v<Wei, void>) {
+    return Edge<Wei>(0ul, 0ul);
+  } else {
+    return Edge<Wei>(0ul, 0ul, Wei{});
+  }
+}
+
+template <class Wei>
+size_t ArenaAdjacency<Wei>::Log2(size_t value) {
+  return 8ul * sizeof(unsigned long long) - 1ul - __builtin_clzll(value);
+}
+
+// Smallest power of two holding `size` arcs, 0 for none
+template <class Wei>
+size_t ArenaAdjacency<Wei>::Capacity(size_t size) {
+  return size < 2ul ? size : size_t{2} << Log2(size - 1ul);
+}
+
+template <class Wei>
+void ArenaAdjacency<Wei>::Grow(Vertex vertex) {
+  Block& block = blocks_[vertex];
+  size_t capacity = std::max(2ul * block.capacity, kMinCapacity);
+  if (block.begin + block.capacity == arcs_.size()) {
+    arcs_.resize(block.begin + capacity, Filler());
+    block.capacity = capacity;
+    return;
+  }
+  size_t log = Log2(capacity);
+  if (free_.size() <= log) {
+    free_.resize(log + 1);
+  }
+  size_t begin;
+  if (free_[log].empty()) {
+    begin = arcs_.size();
+    arcs_.resize(begin + capacity, Filler());
+  } else {
+    begin = free_[log].back();
+    free_[log].pop_back();
+  }
+  std::copy(arcs_.begin() + block.begin, arcs_.begin() + block.begin + block.size, arcs_.begin() + begin);
+  if (block.capacity >= kMinCapacity) {
+    free_[Log2(block.capacity)].emplace_back(block.begin);
+  }
+  block.begin = begin;
+  block.capacity = capacity;
+}
+
+/////////////////////////////
+////  COMPRESSED  ROWS   ////
+/////////////////////////////
+
+// Immutable compressed sparse row storage: arcs of vertex v are
+// dst_[offsets_[v] .. offsets_[v + 1]) with weights packed alongside.
+// The source vertex is not stored, rows yield Edge<Wei> by value.
+template <class Wei>
+class CSRAdjacency {
+  struct NoWeights {};
+  using Weights = std::conditional_t<std::is_same_v<Wei, void>, NoWeights, std::vector<Wei>>;
+
+  std::vector<size_t> offsets_{0ul};
+  std::vector<Vertex> dst_{};
+  Weights weight_{};
+
+ public:
+  class Row;
+  class RowIterator;
+
+  CSRAdjacency() = default;
+  explicit CSRAdjacency(size_t);
+  CSRAdjacency(size_t, const std::vector<Edge<Wei>>&);
+  template <class Other, std::enable_if_t<!std::is_same_v<Other, CSRAdjacency<Wei>>, int> = 0>
+  explicit CSRAdjacency(const Other&);
+
+  size_t size() const;
+  size_t NumArcs() const;
+  Row operator[](Vertex) const;
+  RowIterator begin() const;
+  RowIterator end() const;
+
+ private:
+  Edge<Wei> MakeEdge(Vertex, size_t) const;
+};
+
+template <class Wei>
+class CSRAdjacency<Wei>::Row {
+  const CSRAdjacency<Wei>* storage_;
+  Vertex src_;
+
+ public:
+  class Iterator {
+    const CSRAdjacency<Wei>* storage_;
+    Vertex src_;
+    size_t index_;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Edge<Wei>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Edge<Wei>;
+
+    Iterator(const CSRAdjacency<Wei>* storage, Vertex src, size_t index)
+        : storage_{storage}, src_{src}, index_{index} {
+    }
+    Edge<Wei> operator*() const {
+      return storage_->MakeEdge(src_, index_);
+    }
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return index_ != other.index_;
+    }
+  };
+
+  Row(const CSRAdjacency<Wei>* storage, Vertex src) : storage_{storage}, src_{src} {
+  }
+  Iterator begin() const {
+    return Iterator(storage_, src_, storage_->offsets_[src_]);
+  }
+  Iterator end() const {
+    return Iterator(storage_, src_, storage_->offsets_[src_ + 1]);
+  }
+  size_t size() const {
+    return storage_->offsets_[src_ + 1] - storage_->offsets_[src_];
+  }
+  bool empty() const {
+    return size() == 0ul;
+  }
+};
+
+template <class Wei>
+class CSRAdjacency<Wei>::RowIterator {
+  const CSRAdjacency<Wei>* storage_;
+  Vertex vertex_;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Row;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = Row;
+
+  RowIterator(const CSRAdjacency<Wei>* storage, Vertex vertex) : storage_{storage}, vertex_{vertex} {
+  }
+  Row operator*() const {
+    return Row(storage_, vertex_);
+  }
+  RowIterator& operator++() {
+    ++vertex_;
+    return *this;
+  }
+  bool operator==(const RowIterator& other) const {
+    return vertex_ == other.vertex_;
+  }
+  bool operator!=(const RowIterator& other) const {
+    return vertex_ != other.vertex_;
+  }
+};
+
+template <class Wei>
+CSRAdjacency<Wei>::CSRAdjacency(size_t n) : offsets_(n + 1, 0ul) {
+}
+
+template <class Wei>
+CSRAdjacency<Wei>::CSRAdjacency(size_t n, const std::vector<Edge<Wei>>& arcs) : offsets_(n + 1, 0ul) {
+  for (const auto& arc : arcs) {
+    ++offsets_[arc.src + 1];
+  }
+  for (Vertex vertex = 0; vertex < n; ++vertex) {
+    offsets_[vertex + 1] += offsets_[vertex];
+  }
+  dst_.resize(arcs.size());
+  if constexpr (!std::is_same_v<Wei, void>) {
+    weight_.resize(arcs.size());
+  }
+  std::vector<size_t> position(offsets_.begin(), offsets_.end() - 1);
+  for (const auto& arc : arcs) {
+    size_t index = position[arc.src]++;
+    dst_[index] = arc.dst;
+    if constexpr (!std::is_same_v<Wei, void>) {
+      weight_[index] = arc.weight;
+    }
+  }
+}
+
+template <class Wei>
+template <class Other, std::enable_if_t<!std::is_same_v<Other, CSRAdjacency<Wei>>, int>>
+CSRAdjacency<Wei>::CSRAdjacency(const Other& other) : offsets_(other.size() + 1, 0ul) {
+  for (Vertex vertex = 0; vertex < other.size(); ++vertex) {
+    offsets_[vertex + 1] = offsets_[vertex] + other[vertex].size();
+  }
+  dst_.reserve(offsets_.back());
+  if constexpr (!std::is_same_v<Wei, void>) {
+    weight_.reserve(offsets_.back());
+  }
+  for (Vertex vertex = 0; vertex < other.size(); ++vertex) {
+    for (const auto& edge : other[vertex]) {
+      dst_.emplace_back(edge.dst);
+      if constexpr (!std::is_same_v<Wei, void>) {
+        weight_.emplace_back(edge.weight);
+      }
+    }
+  }
+}
+
+template <class Wei>
+size_t CSRAdjacency<Wei>::size() const {
+  return offsets_.size() - 1;
+}
+
+template <class Wei>
+size_t CSRAdjacency<Wei>::NumArcs() const {
+  return dst_.size();
+}
+
+template <class Wei>
+auto CSRAdjacency<Wei>::operator[](Vertex vertex) const -> Row {
+  return Row(this, vertex);
+}
+
+template <class Wei>
+auto CSRAdjacency<Wei>::begin() const -> RowIterator {
+  return RowIterator(this, 0ul);
+}
+
+template <class Wei>
+auto CSRAdjacency<Wei>::end() const -> RowIterator {
+  return RowIterator(this, size());
+}
+
+template <class Wei>
+Edge<Wei> CSRAdjacency<Wei>::MakeEdge(Vertex src, size_t index) const {
+  if constexpr (std::is_same_v<Wei, void>) {
+    return Edge<Wei>(src, dst_[index]);
+  } else {
+    return Edge<Wei>(src, dst_[index], weight_[index]);
+  }
+}
+
+#endif
@@ -0,0 +1,549 @@
+#ifndef CONTRACTION_HIERARCHY_H_
+#define CONTRACTION_HIERARCHY_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./_graph_class.h"
+#include "../heap/d_ary_heap.h"
+
+// Contraction hierarchy over a static non-negatively weighted graph.
+// Vertices are contracted one by one in order of an edge-difference
+// priority; a shortcut u -> w is added whenever the path u -> v -> w over
+// the contracted vertex v has no witness path of the same length.
+// Queries run a bidirectional Dijkstra that only follows arcs towards
+// higher-ranked vertices, and shortcuts are unpacked back into the
+// original vertices of the path.
+template <class Weight>
+class ContractionHierarchy {
+  static constexpr Vertex kNone = static_cast<Vertex>(-1);
+  static constexpr uint32_t kMagic = 0x31304843u;  // "CH01"
+
+  struct Arc {
+    Vertex dst;
+    Weight weight;
+    Vertex middle;  // contracted vertex of a shortcut, kNone for original arcs
+  };
+
+  std::vector<size_t> rank_;
+  // forward_[offsets] - arcs v -> w with rank[v] < rank[w], stored at v
+  // backward_[offsets] - arcs w -> v with rank[w] > rank[v], stored at v as (w)
+  std::vector<size_t> forward_offsets_{0ul};
+  std::vector<Arc> forward_;
+  std::vector<size_t> backward_offsets_{0ul};
+  std::vector<Arc> backward_;
+
+ public:
+  // Per-thread query buffers, reused between queries
+  class Workspace {
+    struct Side {
+      std::vector<std::optional<Weight>> dist;
+      std::vector<Vertex> parent;
+      std::vector<size_t> parent_arc;
+      std::vector<Vertex> touched;
+      DAryHeap<Weight> queue;
+    };
+    Side sides_[2];
+
+   public:
+    explicit Workspace(size_t);
+    friend class ContractionHierarchy<Weight>;
+  };
+
+  ContractionHierarchy() = default;
+  ContractionHierarchy(size_t, const std::vector<Edge<Weight>>&, size_t max_witness_settled = 500ul);
+
+  size_t Size() const;
+  size_t Rank(Vertex) const;
+  size_t NumShortcuts() const;
+  std::optional<Path<Weight>> Query(Vertex, Vertex) const;
+  std::optional<Path<Weight>> Query(Vertex, Vertex, Workspace&) const;
+
+  void Serialize(std::ostream&) const;
+  static std::optional<ContractionHierarchy<Weight>> Deserialize(std::istream&);
+
+ private:
+  void Unpack(Vertex, const Arc&, std::vector<Vertex>&) const;
+  const Arc& FindArc(const std::vector<size_t>&, const std::vector<Arc>&, Vertex, Vertex) const;
+};
+
+///////////////////////////
+////  PREPROCESSING    ////
+///////////////////////////
+
+template <class Weight>
+ContractionHierarchy<Weight>::Workspace::Workspace(size_t num_vertices) {
+  for (auto& side : sides_) {
+    side.dist.resize(num_vertices);
+    side.parent.resize(num_vertices, kNone);
+    side.parent_arc.resize(num_vertices, 0ul);
+    side.queue = DAryHeap<Weight>(num_vertices);
+  }
+}
+
+template <class Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(size_t num_vertices, const std::vector<Edge<Weight>>& arcs,
+                                                   size_t max_witness_settled)
+    : rank_(num_vertices, 0ul) {
+  // Working graph over uncontracted vertices, parallel arcs merged
+  std::vector<std::vector<Arc>> out(num_vertices);
+  std::vector<std::vector<Arc>> in(num_vertices);
+  auto add_arc = [&out, &in](Vertex src, Vertex dst, Weight weight, Vertex middle) {
+    for (auto& arc : out[src]) {
+      if (arc.dst == dst) {
+        if (weight < arc.weight) {
+          arc.weight = weight;
+          arc.middle = middle;
+          for (auto& back : in[dst]) {
+            if (back.dst == src) {
+              back.weight = weight;
+              back.middle = middle;
+              break;
+            }
+          }
+        }
+        return false;
+      }
+    }
+    out[src].push_back({dst, weight, middle});
+    in[dst].push_back({src, weight, middle});
+    return true;
+  };
+  for (const auto& arc : arcs) {
+    if (arc.src != arc.dst) {
+      add_arc(arc.src, arc.dst, arc.weight, kNone);
+    }
+  }
+
+  std::vector<bool> contracted(num_vertices, false);
+  std::vector<size_t> deleted_neighbours(num_vertices, 0ul);
+
+  // Witness search: bounded Dijkstra from `source` that ignores `skipped`
+  std::vector<std::optional<Weight>> witness(num_vertices);
+  std::vector<Vertex> touched;
+  DAryHeap<Weight> queue(num_vertices);
+  auto witness_search = [&](Vertex source, Vertex skipped, Weight limit) {
+    for (Vertex vertex : touched) {
+      witness[vertex].reset();
+    }
+    touched.clear();
+    queue.Clear();
+    witness[source] = 0;
+    touched.emplace_back(source);
+    queue.Push(source, 0);
+    for (size_t settled = 0; !queue.Empty() && settled < max_witness_settled; ++settled) {
+      auto [dist, vertex] = queue.ExtractMin();
+      if (limit < dist) {
+        break;
+      }
+      for (const auto& arc : out[vertex]) {
+        if (arc.dst == skipped || contracted[arc.dst]) {
+          continue;
+        }
+        Weight new_dist = dist + arc.weight;
+        if (!witness[arc.dst].has_value()) {
+          touched.emplace_back(arc.dst);
+        } else if (!(new_dist < *witness[arc.dst])) {
+          continue;
+        }
+        witness[arc.dst] = new_dist;
+        queue.Push(arc.dst, new_dist);
+      }
+    }
+  };
+
+  // Calls on_shortcut(u, w, weight) for every shortcut contracting v needs
+  auto contract = [&](Vertex vertex, auto&& on_shortcut) {
+    for (const auto& in_arc : in[vertex]) {
+      if (contracted[in_arc.dst]) {
+        continue;
+      }
+      std::optional<Weight> limit{};
+      for (const auto& out_arc : out[vertex]) {
+        if (!contracted[out_arc.dst] && out_arc.dst != in_arc.dst &&
+            (!limit.has_value() || *limit < in_arc.weight + out_arc.weight)) {
+          limit = in_arc.weight + out_arc.weight;
+        }
+      }
+      if (!limit.has_value()) {
+        continue;
+      }
+      witness_search(in_arc.dst, vertex, *limit);
+      for (const auto& out_arc : out[vertex]) {
+        if (contracted[out_arc.dst] || out_arc.dst == in_arc.dst) {
+          continue;
+        }
+        Weight via = in_arc.weight + out_arc.weight;
+        if (!witness[out_arc.dst].has_value() || via < *witness[out_arc.dst]) {
+          on_shortcut(in_arc.dst, out_arc.dst, via);
+        }
+      }
+    }
+  };
+
+  auto priority = [&](Vertex vertex) {
+    int64_t num_shortcuts = 0;
+    contract(vertex, [&num_shortcuts](Vertex, Vertex, Weight) { ++num_shortcuts; });
+    int64_t degree = 0;
+    for (const auto& arc : out[vertex]) {
+      degree += contracted[arc.dst] ? 0 : 1;
+    }
+    for (const auto& arc : in[vertex]) {
+      degree += contracted[arc.dst] ? 0 : 1;
+    }
+    return num_shortcuts - degree + static_cast<int64_t>(deleted_neighbours[vertex]);
+  };
+
+  using Entry = std::pair<int64_t, Vertex>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> order;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    order.emplace(priority(vertex), vertex);
+  }
+
+  std::vector<std::vector<Arc>> forward(num_vertices);
+  std::vector<std::vector<Arc>> backward(num_vertices);
+  size_t next_rank = 0ul;
+  while (!order.empty()) {
+    Vertex vertex = order.top().second;
+    order.pop();
+    if (contracted[vertex]) {
+      continue;
+    }
+    // Lazy update: contract only if the priority is still the smallest
+    int64_t current = priority(vertex);
+    if (!order.empty() && order.top().first < current) {
+      order.emplace(current, vertex);
+      continue;
+    }
+
+    contract(vertex, [&](Vertex src, Vertex dst, Weight weight) { add_arc(src, dst, weight, vertex); });
+    contracted[vertex] = true;
+    rank_[vertex] = next_rank++;
+    for (const auto& arc : out[vertex]) {
+      if (!contracted[arc.dst]) {
+        forward[vertex].emplace_back(arc);
+        ++deleted_neighbours[arc.dst];
+      }
+    }
+    for (const auto& arc : in[vertex]) {
+      if (!contracted[arc.dst]) {
+        backward[vertex].emplace_back(arc);
+        ++deleted_neighbours[arc.dst];
+      }
+    }
+    // Detach the contracted vertex so later searches do not scan it
+    auto detach = [vertex](std::vector<Arc>& arcs) {
+      for (size_t index = 0; index < arcs.size(); ++index) {
+        if (arcs[index].dst == vertex) {
+          arcs[index] = arcs.back();
+          arcs.pop_back();
+          return;
+        }
+      }
+    };
+    for (const auto& arc : out[vertex]) {
+      detach(in[arc.dst]);
+    }
+    for (const auto& arc : in[vertex]) {
+      detach(out[arc.dst]);
+    }
+    std::vector<Arc>().swap(out[vertex]);
+    std::vector<Arc>().swap(in[vertex]);
+  }
+
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    forward_.insert(forward_.end(), forward[vertex].begin(), forward[vertex].end());
+    forward_offsets_.emplace_back(forward_.size());
+    backward_.insert(backward_.end(), backward[vertex].begin(), backward[vertex].end());
+    backward_offsets_.emplace_back(backward_.size());
+  }
+}
+
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+ContractionHierarchy<Weight> Graph<dir, Wei, Adj>::BuildContractionHierarchy(size_t max_witness_settled) const {
+  std::vector<Edge<Weight>> arcs;
+  for (const auto& curr_edges : adj_list_) {
+    for (const auto& edge : curr_edges) {
+      arcs.emplace_back(edge);
+    }
+  }
+  return ContractionHierarchy<Weight>(adj_list_.size(), arcs, max_witness_settled);
+}
+
+/////////////////////
+////  QUERIES    ////
+/////////////////////
+
+template <class Weight>
+size_t ContractionHierarchy<Weight>::Size() const {
+  return rank_.size();
+}
+
+template <class Weight>
+size_t ContractionHierarchy<Weight>::Rank(Vertex vertex) const {
+  return rank_[vertex];
+}
+
+template <class Weight>
+size_t ContractionHierarchy<Weight>::NumShortcuts() const {
+  size_t num_shortcuts = 0ul;
+  for (const auto& arc : forward_) {
+    num_shortcuts += arc.middle != kNone;
+  }
+  for (const auto& arc : backward_) {
+    num_shortcuts += arc.middle != kNone;
+  }
+  return num_shortcuts;
+}
+
+template <class Weight>
+std::optional<Path<Weight>> ContractionHierarchy<Weight>::Query(Vertex source, Vertex target) const {
+  Workspace workspace(rank_.size());
+  return Query(source, target, workspace);
+}
+
+template <class Weight>
+std::optional<Path<Weight>> ContractionHierarchy<Weight>::Query(Vertex source, Vertex target,
+                                                                Workspace& workspace) const {
+  const std::vector<size_t>* offsets[2] = {&forward_offsets_, &backward_offsets_};
+  const std::vector<Arc>* arcs[2] = {&forward_, &backward_};
+  auto& sides = workspace.sides_;
+  for (auto& side : sides) {
+    for (Vertex vertex : side.touched) {
+      side.dist[vertex].reset();
+      side.parent[vertex] = kNone;
+    }
+    side.touched.clear();
+    side.queue.Clear();
+  }
+  Vertex starts[2] = {source, target};
+  for (size_t index = 0; index < 2; ++index) {
+    sides[index].dist[starts[index]] = 0;
+    sides[index].touched.emplace_back(starts[index]);
+    sides[index].queue.Push(starts[index], 0);
+  }
+
+  std::optional<Weight> best{};
+  Vertex meeting = kNone;
+  size_t num_settled = 0ul;
+  bool active[2] = {true, true};
+  for (size_t turn = 0; active[0] || active[1]; turn ^= 1ul) {
+    if (!active[turn]) {
+      continue;
+    }
+    auto& side = sides[turn];
+    if (side.queue.Empty()) {
+      active[turn] = false;
+      continue;
+    }
+    auto [dist, vertex] = side.queue.ExtractMin();
+    if (best.has_value() && !(dist < *best)) {
+      active[turn] = false;
+      continue;
+    }
+    ++num_settled;
+    const auto& other = sides[turn ^ 1ul];
+    if (other.dist[vertex].has_value() && (!best.has_value() || dist + *other.dist[vertex] < *best)) {
+      best = dist + *other.dist[vertex];
+      meeting = vertex;
+    }
+    for (size_t index = (*offsets[turn])[vertex]; index < (*offsets[turn])[vertex + 1]; ++index) {
+      const Arc& arc = (*arcs[turn])[index];
+      Weight new_dist = dist + arc.weight;
+      if (!side.dist[arc.dst].has_value()) {
+        side.touched.emplace_back(arc.dst);
+      } else if (!(new_dist < *side.dist[arc.dst])) {
+        continue;
+      }
+      side.dist[arc.dst] = new_dist;
+      side.parent[arc.dst] = vertex;
+      side.parent_arc[arc.dst] = index;
+      side.queue.Push(arc.dst, new_dist);
+    }
+  }
+  if (!best.has_value()) {
+    return {};
+  }
+
+  // Upward arcs from source to the meeting vertex, then back down to target
+  std::vector<std::pair<Vertex, const Arc*>> up;
+  for (Vertex curr = meeting; sides[0].parent[curr] != kNone; curr = sides[0].parent[curr]) {
+    up.emplace_back(sides[0].parent[curr], &forward_[sides[0].parent_arc[curr]]);
+  }
+  std::vector<Vertex> path{source};
+  for (auto it = up.rbegin(); it != up.rend(); ++it) {
+    Unpack(it->first, *it->second, path);
+  }
+  for (Vertex curr = meeting; sides[1].parent[curr] != kNone; curr = sides[1].parent[curr]) {
+    // backward arc stored at parent pointing to curr is the original arc curr -> parent
+    const Arc& arc = backward_[sides[1].parent_arc[curr]];
+    Unpack(curr, Arc{sides[1].parent[curr], arc.weight, arc.middle}, path);
+  }
+  return Path<Weight>{*best, std::move(path), num_settled};
+}
+
+// Appends the vertices after `src` of the original path behind arc src -> arc.dst
+template <class Weight>
+void ContractionHierarchy<Weight>::Unpack(Vertex src, const Arc& arc, std::vector<Vertex>& path) const {
+  std::vector<std::pair<Vertex, Arc>> stack{{src, arc}};
+  while (!stack.empty()) {
+    auto [from, curr] = stack.back();
+    stack.pop_back();
+    if (curr.middle == kNone) {
+      path.emplace_back(curr.dst);
+      continue;
+    }
+    // from -> middle is stored in backward_ at middle, middle -> dst in forward_ at middle
+    const Arc& second = FindArc(forward_offsets_, forward_, curr.middle, curr.dst);
+    const Arc& first = FindArc(backward_offsets_, backward_, curr.middle, from);
+    stack.emplace_back(curr.middle, second);
+    stack.emplace_back(from, Arc{curr.middle, first.weight, first.middle});
+  }
+}
+
+template <class Weight>
+auto ContractionHierarchy<Weight>::FindArc(const std::vector<size_t>& offsets, const std::vector<Arc>& arcs,
+                                           Vertex vertex, Vertex dst) const -> const Arc& {
+  size_t index = offsets[vertex];
+  while (index < offsets[vertex + 1] && arcs[index].dst != dst) {
+    ++index;
+  }
+  // Both halves of every shortcut exist, Deserialize checks it for loaded ones
+  assert(index < offsets[vertex + 1]);
+  return arcs[index];
+}
+
+///////////////////////////
+////  SERIALIZATION    ////
+///////////////////////////
+
+namespace detail {
+template <class T>
+void WriteArray(std::ostream& os, const std::vector<T>& array) {
+  uint64_t size = array.size();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(reinterpret_cast<const char*>(array.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+// Reads in bounded chunks, so a corrupt size fails at the end of the
+// stream instead of allocating whatever it claims
+template <class T>
+bool ReadArray(std::istream& is, std::vector<T>& array) {
+  constexpr uint64_t kChunk = (uint64_t{1} << 20) / sizeof(T) + 1;
+  uint64_t size = 0;
+  if (!is.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  array.clear();
+  while (array.size() < size) {
+    size_t done = array.size();
+    size_t count = static_cast<size_t>(std::min<uint64_t>(kChunk, size - done));
+    array.resize(done + count);
+    auto bytes = static_cast<std::streamsize>(count * sizeof(T));
+    if (!is.read(reinterpret_cast<char*>(array.data() + done), bytes)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace detail
+
+// Binary layout: magic, sizeof(Weight), then rank, forward and backward
+// arrays as (uint64 size, raw elements). Readable only on a machine with
+// the same endianness and Weight type.
+template <class Weight>
+void ContractionHierarchy<Weight>::Serialize(std::ostream& os) const {
+  static_assert(std::is_trivially_copyable_v<Weight>, "Serialize requires a trivially copyable Weight");
+  uint32_t header[2] = {kMagic, static_cast<uint32_t>(sizeof(Weight))};
+  os.write(reinterpret_cast<const char*>(header), sizeof(header));
+  detail::WriteArray(os, rank_);
+  detail::WriteArray(os, forward_offsets_);
+  detail::WriteArray(os, forward_);
+  detail::WriteArray(os, backward_offsets_);
+  detail::WriteArray(os, backward_);
+}
+
+template <class Weight>
+std::optional<ContractionHierarchy<Weight>> ContractionHierarchy<Weight>::Deserialize(std::istream& is) {
+  static_assert(std::is_trivially_copyable_v<Weight>, "Deserialize requires a trivially copyable Weight");
+  uint32_t header[2] = {0u, 0u};
+  if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kMagic ||
+      header[1] != sizeof(Weight)) {
+    return {};
+  }
+  ContractionHierarchy<Weight> hierarchy;
+  if (!detail::ReadArray(is, hierarchy.rank_) || !detail::ReadArray(is, hierarchy.forward_offsets_) ||
+      !detail::ReadArray(is, hierarchy.forward_) || !detail::ReadArray(is, hierarchy.backward_offsets_) ||
+      !detail::ReadArray(is, hierarchy.backward_)) {
+    return {};
+  }
+  // Everything Query indexes with has to stay in bounds
+  size_t num_vertices = hierarchy.rank_.size();
+  auto valid = [num_vertices](const std::vector<size_t>& offsets, const std::vector<Arc>& arcs) {
+    if (offsets.size() != num_vertices + 1 || offsets.front() != 0ul || offsets.back() != arcs.size()) {
+      return false;
+    }
+    for (size_t vertex = 0; vertex < num_vertices; ++vertex) {
+      if (offsets[vertex] > offsets[vertex + 1]) {
+        return false;
+      }
+    }
+    for (const auto& arc : arcs) {
+      if (arc.dst >= num_vertices || (arc.middle != kNone && arc.middle >= num_vertices)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!valid(hierarchy.forward_offsets_, hierarchy.forward_) ||
+      !valid(hierarchy.backward_offsets_, hierarchy.backward_)) {
+    return {};
+  }
+  // Unpacking a shortcut src -> dst looks up src -> middle in the backward
+  // row and middle -> dst in the forward row of its middle vertex. The
+  // middle has to rank below both ends, so that unpacking terminates.
+  const auto& rank = hierarchy.rank_;
+  auto has_arc = [](const std::vector<size_t>& offsets, const std::vector<Arc>& arcs, Vertex vertex, Vertex dst) {
+    for (size_t index = offsets[vertex]; index < offsets[vertex + 1]; ++index) {
+      if (arcs[index].dst == dst) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto valid_shortcut = [&](Vertex src, Vertex dst, Vertex middle) {
+    return middle == kNone ||
+           (rank[middle] < rank[src] && rank[middle] < rank[dst] &&
+            has_arc(hierarchy.backward_offsets_, hierarchy.backward_, middle, src) &&
+            has_arc(hierarchy.forward_offsets_, hierarchy.forward_, middle, dst));
+  };
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (size_t index = hierarchy.forward_offsets_[vertex]; index < hierarchy.forward_offsets_[vertex + 1]; ++index) {
+      const Arc& arc = hierarchy.forward_[index];
+      if (!valid_shortcut(vertex, arc.dst, arc.middle)) {
+        return {};
+      }
+    }
+    for (size_t index = hierarchy.backward_offsets_[vertex]; index < hierarchy.backward_offsets_[vertex + 1];
+         ++index) {
+      const Arc& arc = hierarchy.backward_[index];
+      if (!valid_shortcut(arc.dst, vertex, arc.middle)) {
+        return {};
+      }
+    }
+  }
+  return hierarchy;
+}
+
+#endif
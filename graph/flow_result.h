@@ -0,0 +1,139 @@
+#ifndef FLOW_RESULT_H_
+#define FLOW_RESULT_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "./_graph_class.h"
+#include "./_graph_residual.h"
+#include "./graph_flows.h"
+
+// Maximum flow that keeps its residual network around. Edges are numbered
+// by their position in adjacency order (vertex by vertex, row by row), so
+// an undirected edge has two numbers, one per direction. Capacities can
+// be raised afterwards and Augment() continues from the current flow.
+template <class Cap>
+class FlowResult {
+  detail::ResidualNetwork<Cap> net_;
+  Vertex source_{0};
+  Vertex sink_{0};
+  Cap value_{};
+
+ public:
+  FlowResult() = default;
+  FlowResult(detail::ResidualNetwork<Cap>, Vertex, Vertex);
+
+  Cap Value() const;
+  size_t NumEdges() const;
+  Vertex Tail(size_t) const;
+  Vertex Head(size_t) const;
+  Cap Flow(size_t) const;
+  std::vector<Cap> Flows() const;
+  Cap ResidualCapacity(size_t) const;
+  // Vertices reachable from the source in the residual network
+  std::vector<bool> MinCut() const;
+  // Edges from the source side to the sink side of MinCut()
+  std::vector<size_t> CutEdges() const;
+
+  void IncreaseCapacity(size_t, Cap);
+  // Augments to a maximum flow again, returns the flow added
+  Cap Augment();
+};
+
+template <class Cap>
+FlowResult<Cap>::FlowResult(detail::ResidualNetwork<Cap> net, Vertex source, Vertex sink)
+    : net_{std::move(net)}, source_{source}, sink_{sink} {
+  Augment();
+}
+
+template <class Cap>
+Cap FlowResult<Cap>::Value() const {
+  return value_;
+}
+
+template <class Cap>
+size_t FlowResult<Cap>::NumEdges() const {
+  return net_.forward.size();
+}
+
+template <class Cap>
+Vertex FlowResult<Cap>::Tail(size_t edge) const {
+  return net_.head[net_.reverse[net_.forward[edge]]];
+}
+
+template <class Cap>
+Vertex FlowResult<Cap>::Head(size_t edge) const {
+  return net_.head[net_.forward[edge]];
+}
+
+// The paired arc starts with zero capacity, so its residual is the flow
+template <class Cap>
+Cap FlowResult<Cap>::Flow(size_t edge) const {
+  return net_.residual[net_.reverse[net_.forward[edge]]];
+}
+
+template <class Cap>
+std::vector<Cap> FlowResult<Cap>::Flows() const {
+  std::vector<Cap> flows(NumEdges());
+  for (size_t edge = 0; edge < flows.size(); ++edge) {
+    flows[edge] = Flow(edge);
+  }
+  return flows;
+}
+
+template <class Cap>
+Cap FlowResult<Cap>::ResidualCapacity(size_t edge) const {
+  return net_.residual[net_.forward[edge]];
+}
+
+template <class Cap>
+std::vector<bool> FlowResult<Cap>::MinCut() const {
+  std::vector<bool> source_side(net_.NumVertices(), false);
+  source_side[source_] = true;
+  std::vector<Vertex> order{source_};
+  for (size_t index = 0; index < order.size(); ++index) {
+    Vertex vertex = order[index];
+    for (size_t arc = net_.offsets[vertex]; arc < net_.offsets[vertex + 1]; ++arc) {
+      Vertex neigh = net_.head[arc];
+      if (!source_side[neigh] && net_.residual[arc] > Cap{}) {
+        source_side[neigh] = true;
+        order.emplace_back(neigh);
+      }
+    }
+  }
+  return source_side;
+}
+
+template <class Cap>
+std::vector<size_t> FlowResult<Cap>::CutEdges() const {
+  std::vector<bool> source_side = MinCut();
+  std::vector<size_t> edges;
+  for (size_t edge = 0; edge < NumEdges(); ++edge) {
+    if (source_side[Tail(edge)] && !source_side[Head(edge)]) {
+      edges.emplace_back(edge);
+    }
+  }
+  return edges;
+}
+
+template <class Cap>
+void FlowResult<Cap>::IncreaseCapacity(size_t edge, Cap delta) {
+  net_.residual[net_.forward[edge]] += delta;
+}
+
+template <class Cap>
+Cap FlowResult<Cap>::Augment() {
+  Cap added = detail::Dinic<Cap>(net_).Run(source_, sink_);
+  value_ += added;
+  return added;
+}
+
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifWeighted<Wei, Weight>>
+FlowResult<Weight> Graph<dir, Wei, Adj>::MaxFlow(Vertex source, Vertex destination) const {
+  detail::ResidualNetwork<Weight> net(adj_list_, [](const auto& edge) { return edge.weight; });
+  return FlowResult<Weight>(std::move(net), source, destination);
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include "./graph_mst.h"
 #include "./graph_distance.h"
 #include "./graph_flows.h"
+#include "./contraction_hierarchy.h"
+#include "./flow_result.h"
 
 template <class Weight = void>
 using UndirectedGraph = Graph<false, Weight>;
@@ -17,4 +19,10 @@ using UndirectedGraph = Graph<false, Weight>;
 template <class Weight = void>
 using DirectedGraph = Graph<true, Weight>;
 
+template <bool dir, class Weight = void>
+using CSRGraph = Graph<dir, Weight, CSRAdjacency<Weight>>;
+
+template <bool dir, class Weight = void>
+using ArenaGraph = Graph<dir, Weight, ArenaAdjacency<Weight>>;
+
 #endif
\ No newline at end of file
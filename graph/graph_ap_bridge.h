@@ -3,112 +3,288 @@
 
 #include "./_graph_class.h"
 
-template <bool dir, class Wei>
+// Both run an explicit-stack DFS with low links in time[v].second; a
+// child's low link is merged into its parent when the child's frame is
+// popped, at the point where the recursive version returns.
+template <bool dir, class Wei, class Adj>
 template <bool directed, EnifUndirected<dir, directed>>
-std::vector<Vertex> Graph<dir, Wei>::ArticulationPoints() const {
+std::vector<Vertex> Graph<dir, Wei, Adj>::ArticulationPoints() const {
   DFStimes time(adj_list_.size(), std::make_pair<size_t, size_t>(0ul, 0ul));  // first = time_in, second = time_up
   std::vector<Color> color(adj_list_.size(), Color::kWhite);
+  std::vector<bool> is_ap(adj_list_.size(), false);
   std::vector<Vertex> artic_points{};
+  std::vector<DfsFrame> stack;
   size_t curr_time = 0ul;
-  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-    if (color[vertex] == Color::kWhite) {
-      RecursiveAP({}, vertex, time, color, artic_points, curr_time);
+  auto enter = [&](Vertex vertex) {
+    color[vertex] = Color::kGrey;
+    time[vertex].first = time[vertex].second = ++curr_time;
+    stack.emplace_back(MakeFrame(vertex));
+  };
+
+  for (Vertex root = 0; root < adj_list_.size(); ++root) {
+    if (color[root] != Color::kWhite) {
+      continue;
     }
-  }
-  return artic_points;
-}
+    size_t num_children = 0ul;
+    enter(root);
+    while (!stack.empty()) {
+      DfsFrame& frame = stack.back();
+      Vertex vertex = frame.vertex;
+      if (frame.next != frame.end) {
+        Vertex child = (*frame.next).dst;
+        ++frame.next;
+        if (color[child] == Color::kWhite) {
+          num_children += vertex == root;
+          enter(child);
+        } else if (color[child] == Color::kGrey) {
+          time[vertex].second = std::min(time[vertex].second, time[child].first);
+        }
+        continue;
+      }
 
-template <bool dir, class Wei>
-void Graph<dir, Wei>::RecursiveAP(std::optional<Vertex> parent, Vertex vertex, DFStimes& time,
-                                  std::vector<Color>& color, std::vector<Vertex>& artic_points,
-                                  size_t& curr_time) const {
-  color[vertex] = Color::kGrey;
-  time[vertex].first = time[vertex].second = ++curr_time;
-  bool is_ap = false;
-  size_t num_children = 0ul;
-
-  for (const auto& edge : adj_list_[vertex]) {
-    Vertex child = edge.dst;
-    if (color[child] == Color::kWhite) {
-      ++num_children;
-      RecursiveAP(vertex, child, time, color, artic_points, curr_time);
-      time[vertex].second = std::min(time[vertex].second, time[child].second);
-      if (parent.has_value() && time[child].second >= time[vertex].first) {
-        is_ap = true;
+      stack.pop_back();
+      if (vertex == root ? num_children > 1ul : is_ap[vertex]) {
+        artic_points.emplace_back(vertex);
+      }
+      color[vertex] = Color::kBlack;
+      if (!stack.empty()) {
+        Vertex parent = stack.back().vertex;
+        time[parent].second = std::min(time[parent].second, time[vertex].second);
+        if (parent != root && time[vertex].second >= time[parent].first) {
+          is_ap[parent] = true;
+        }
       }
-    } else if (color[child] == Color::kGrey) {
-      time[vertex].second = std::min(time[vertex].second, time[child].first);
     }
   }
-  if (!parent.has_value() && num_children > 1ul) {
-    is_ap = true;
-  }
-
-  if (is_ap) {
-    artic_points.emplace_back(vertex);
-  }
-  color[vertex] = Color::kBlack;
+  return artic_points;
 }
 
-template <bool dir, class Wei>
+// The arc back to the DFS parent is skipped once, so parallel edges are
+// never reported as bridges
+template <bool dir, class Wei, class Adj>
 template <bool directed, EnifUndirected<dir, directed>>
-std::vector<Edge<Wei>> Graph<dir, Wei>::Bridges() const {
+std::vector<Edge<Wei>> Graph<dir, Wei, Adj>::Bridges() const {
   DFStimes time(adj_list_.size(), std::make_pair<size_t, size_t>(0ul, 0ul));  // first = time_in, second = time_up
   std::vector<Color> color(adj_list_.size(), Color::kWhite);
+  std::vector<bool> parent_skipped(adj_list_.size(), false);
   std::vector<Edge<Wei>> bridges{};
+  // Frames of the DFS path paired with the tree edge that led to them
+  std::vector<DfsFrame> stack;
+  std::vector<Edge<Wei>> tree_edges;
   size_t curr_time = 0ul;
-  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-    if (color[vertex] == Color::kWhite) {
-      RecursiveBridges({}, vertex, time, color, bridges, curr_time);
+  auto enter = [&](Vertex vertex) {
+    color[vertex] = Color::kGrey;
+    time[vertex].first = time[vertex].second = ++curr_time;
+    stack.emplace_back(MakeFrame(vertex));
+  };
+
+  for (Vertex root = 0; root < adj_list_.size(); ++root) {
+    if (color[root] != Color::kWhite) {
+      continue;
+    }
+    enter(root);
+    while (!stack.empty()) {
+      DfsFrame& frame = stack.back();
+      Vertex vertex = frame.vertex;
+      if (frame.next != frame.end) {
+        Edge<Wei> edge = *frame.next;
+        ++frame.next;
+        Vertex child = edge.dst;
+        if (stack.size() > 1ul && child == stack[stack.size() - 2].vertex && !parent_skipped[vertex]) {
+          parent_skipped[vertex] = true;
+          continue;
+        }
+        if (color[child] == Color::kWhite) {
+          tree_edges.emplace_back(edge);
+          enter(child);
+        } else if (color[child] == Color::kGrey) {
+          time[vertex].second = std::min(time[vertex].second, time[child].first);
+        }
+        continue;
+      }
+
+      stack.pop_back();
+      color[vertex] = Color::kBlack;
+      if (!stack.empty()) {
+        Vertex parent = stack.back().vertex;
+        time[parent].second = std::min(time[parent].second, time[vertex].second);
+        if (time[vertex].second > time[parent].first) {
+          bridges.emplace_back(tree_edges.back());
+        }
+        tree_edges.pop_back();
+      }
     }
   }
+  return bridges;
+}
+
+// Everything Biconnectivity() finds in one DFS. Undirected edges are
+// numbered once each, in adjacency order of their first stored copy.
+// Block-cut tree nodes [0, num_blocks) are the blocks, the following ones
+// the articulation points in increasing order.
+template <class Wei>
+struct Biconnected {
+  std::vector<Edge<Wei>> edges;
+  std::vector<Vertex> articulation_points;
+  std::vector<size_t> bridges;                 // indices into edges
+  std::vector<size_t> two_edge_component;      // per vertex
+  size_t num_two_edge_components{0ul};
+  std::vector<size_t> block;                   // per edge, kNone for loops
+  size_t num_blocks{0ul};
+  Graph<false> block_cut_tree;
+  std::vector<size_t> tree_node;               // per vertex, kNone if isolated
 
-  // delete multiple edges
-  std::unordered_map<Edge<Wei>, size_t> num_edge{};
-  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+};
+
+// Iterative Hopcroft-Tarjan over flat arcs. Only the arc of the tree edge
+// itself is skipped on the way back, so parallel edges are not bridges.
+// Tree and back edges go on an edge stack that is cut into blocks, and
+// vertices on a vertex stack that is cut into 2-edge-connected components
+// below every bridge.
+template <bool dir, class Wei, class Adj>
+template <bool directed, EnifUndirected<dir, directed>>
+Biconnected<Wei> Graph<dir, Wei, Adj>::Biconnectivity() const {
+  constexpr size_t kNone = Biconnected<Wei>::kNone;
+  const size_t num_vertices = adj_list_.size();
+  std::vector<size_t> offsets = ArcOffsets();
+  std::vector<Vertex> head = ArcHeads();
+  std::vector<size_t> twin = ArcTwins(offsets, head);
+
+  Biconnected<Wei> result;
+  std::vector<size_t> edge_of(head.size());
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    size_t arc = offsets[vertex];
     for (const auto& edge : adj_list_[vertex]) {
-      if (num_edge.find(edge) != num_edge.end()) {
-        ++num_edge[edge];
-      } else {
-        num_edge[edge] = 1ul;
+      if (arc < twin[arc]) {
+        edge_of[arc] = edge_of[twin[arc]] = result.edges.size();
+        result.edges.emplace_back(edge);
       }
+      ++arc;
     }
   }
-  for (const auto& [edge, num] : num_edge) {
-    if (num <= 1ul) {
+  const size_t num_edges = result.edges.size();
+  result.block.assign(num_edges, kNone);
+  result.two_edge_component.assign(num_vertices, kNone);
+
+  struct Frame {
+    Vertex vertex;
+    size_t next_arc;
+    size_t parent_edge;
+  };
+  std::vector<size_t> time_in(num_vertices, kNone);
+  std::vector<size_t> time_up(num_vertices);
+  std::vector<bool> is_articulation(num_vertices, false);
+  std::vector<Frame> stack;
+  std::vector<size_t> edge_stack;
+  std::vector<Vertex> vertex_stack;
+  // Vertices of every block, flattened
+  std::vector<size_t> block_offsets{0ul};
+  std::vector<Vertex> block_vertices;
+  std::vector<size_t> in_block(num_vertices, kNone);
+  size_t curr_time = 0ul;
+  auto enter = [&](Vertex vertex, size_t parent_edge) {
+    time_in[vertex] = time_up[vertex] = curr_time++;
+    stack.push_back({vertex, offsets[vertex], parent_edge});
+    vertex_stack.emplace_back(vertex);
+  };
+  auto add_to_block = [&](Vertex vertex) {
+    if (in_block[vertex] != result.num_blocks) {
+      in_block[vertex] = result.num_blocks;
+      block_vertices.emplace_back(vertex);
+    }
+  };
+  auto close_two_edge_component = [&](Vertex top) {
+    Vertex member;
+    do {
+      member = vertex_stack.back();
+      vertex_stack.pop_back();
+      result.two_edge_component[member] = result.num_two_edge_components;
+    } while (member != top);
+    ++result.num_two_edge_components;
+  };
+
+  for (Vertex root = 0; root < num_vertices; ++root) {
+    if (time_in[root] != kNone) {
       continue;
     }
-    auto it = bridges.find(edge);
-    if (it != bridges.end()) {
-      bridges.erase(it);
+    size_t num_children = 0ul;
+    enter(root, kNone);
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      Vertex vertex = frame.vertex;
+      if (frame.next_arc < offsets[vertex + 1]) {
+        size_t arc = frame.next_arc++;
+        size_t edge = edge_of[arc];
+        Vertex child = head[arc];
+        if (edge == frame.parent_edge) {
+          continue;
+        }
+        if (time_in[child] == kNone) {
+          num_children += vertex == root;
+          edge_stack.emplace_back(edge);
+          enter(child, edge);
+        } else if (time_in[child] < time_in[vertex]) {
+          edge_stack.emplace_back(edge);
+          time_up[vertex] = std::min(time_up[vertex], time_in[child]);
+        }
+        continue;
+      }
+
+      size_t tree_edge = frame.parent_edge;
+      stack.pop_back();
+      if (stack.empty()) {
+        close_two_edge_component(vertex);
+        break;
+      }
+      Vertex parent = stack.back().vertex;
+      time_up[parent] = std::min(time_up[parent], time_up[vertex]);
+      if (time_up[vertex] > time_in[parent]) {
+        result.bridges.emplace_back(tree_edge);
+        close_two_edge_component(vertex);
+      }
+      if (time_up[vertex] >= time_in[parent]) {
+        if (parent != root) {
+          is_articulation[parent] = true;
+        }
+        size_t edge;
+        do {
+          edge = edge_stack.back();
+          edge_stack.pop_back();
+          result.block[edge] = result.num_blocks;
+          add_to_block(result.edges[edge].src);
+          add_to_block(result.edges[edge].dst);
+        } while (edge != tree_edge);
+        block_offsets.emplace_back(block_vertices.size());
+        ++result.num_blocks;
+      }
+    }
+    if (num_children > 1ul) {
+      is_articulation[root] = true;
     }
   }
-  return bridges;
-}
-
-template <bool dir, class Wei>
-void Graph<dir, Wei>::RecursiveBridges(std::optional<Vertex> parent, Vertex vertex, DFStimes& time,
-                                       std::vector<Color>& color, std::unordered_set<Edge<Wei>>& bridges,
-                                       size_t& curr_time) const {
-  color[vertex] = Color::kGrey;
-  time[vertex].first = time[vertex].second = ++curr_time;
 
-  for (const auto& edge : adj_list_[vertex]) {
-    Vertex child = edge.dst;
-    if (child == parent) {
-      continue;
+  // Block-cut tree
+  result.tree_node.assign(num_vertices, kNone);
+  size_t num_nodes = result.num_blocks;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (is_articulation[vertex]) {
+      result.articulation_points.emplace_back(vertex);
+      result.tree_node[vertex] = num_nodes++;
     }
-    if (color[child] == Color::kWhite) {
-      RecursiveBridges(vertex, child, time, color, bridges, curr_time);
-      time[vertex].second = std::min(time[vertex].second, time[child].second);
-      if (time[child].second > time[vertex].first) {
-        bridges.emplace(edge);
+  }
+  result.block_cut_tree = Graph<false>(num_nodes);
+  for (size_t block = 0; block < result.num_blocks; ++block) {
+    for (size_t index = block_offsets[block]; index < block_offsets[block + 1]; ++index) {
+      Vertex vertex = block_vertices[index];
+      if (is_articulation[vertex]) {
+        result.block_cut_tree.AddEdge(block, result.tree_node[vertex]);
+      } else {
+        result.tree_node[vertex] = block;
       }
-    } else if (color[child] == Color::kGrey) {
-      time[vertex].second = std::min(time[vertex].second, time[child].first);
     }
   }
-  color[vertex] = Color::kBlack;
+  return result;
 }
 
-#endif
\ No newline at end of file
+#endif
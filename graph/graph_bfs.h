@@ -1,12 +1,21 @@
 #ifndef GRAPH_BFS_H_
 #define GRAPH_BFS_H_
 
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <deque>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 #include "./_graph_class.h"
+#include "../heap/dial_queue.h"
+#include "../heap/radix_heap.h"
 
-template <bool dir, class Wei>
-std::vector<size_t> Graph<dir, Wei>::BFS(Vertex vertex) const {
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::BFS(Vertex vertex) const {
   std::vector<size_t> dist(adj_list_.size(), static_cast<size_t>(-1));
   std::vector<bool> visited(adj_list_.size(), false);
 
@@ -29,67 +38,301 @@ std::vector<size_t> Graph<dir, Wei>::BFS(Vertex vertex) const {
   return dist;
 }
 
-template <bool dir, class Wei>
-template <class Weight, EnifWeighted<Wei, Weight>>
-std::vector<size_t> Graph<dir, Wei>::BFS_01(Vertex vertex) const {
+// Dijkstra over non-negative integer weights with a monotone integer
+// queue (DialQueue, RadixHeap). Vertices are pushed only when their
+// distance improves and stale entries are skipped once the vertex is
+// settled.
+template <bool dir, class Wei, class Adj>
+template <class Queue>
+std::vector<size_t> Graph<dir, Wei, Adj>::BucketSSSP(Vertex vertex, Queue&& queue) const {
   std::vector<size_t> dist(adj_list_.size(), static_cast<size_t>(-1));
-  std::vector<bool> visited(adj_list_.size(), false);
+  std::vector<bool> settled(adj_list_.size(), false);
 
   dist[vertex] = 0;
-  visited[vertex] = true;
+  queue.Push(vertex, 0ul);
+  while (!queue.Empty()) {
+    auto [curr_dist, curr] = queue.ExtractMin();
+    if (settled[curr]) {
+      continue;
+    }
+    settled[curr] = true;
+    for (const auto& edge : adj_list_[curr]) {
+      size_t new_dist = curr_dist + static_cast<size_t>(edge.weight);
+      if (new_dist < dist[edge.dst]) {
+        dist[edge.dst] = new_dist;
+        queue.Push(edge.dst, new_dist);
+      }
+    }
+  }
+  return dist;
+}
 
-  std::deque<Vertex> queue{vertex};
-  while (!queue.empty()) {
-    auto curr = queue.front();
-    queue.pop_front();
-    for (auto edge : adj_list_[curr]) {
-      if (!visited[edge.dst]) {
-        if (edge.weight) {
-          queue.emplace_back(edge.dst);
-        } else {
-          queue.emplace_front(edge.dst);
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::vector<size_t> Graph<dir, Wei, Adj>::BFS_01(Vertex vertex) const {
+  return BucketSSSP(vertex, DialQueue<size_t>(adj_list_.size(), 1ul));
+}
+
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::vector<size_t> Graph<dir, Wei, Adj>::BFS_0k(Vertex vertex, size_t k) const {
+  return BucketSSSP(vertex, DialQueue<size_t>(adj_list_.size(), k));
+}
+
+// RadixHeap by default, its work only depends on the key width. DialQueue
+// sizes its buckets to the largest arc weight, so pass it only when the
+// weights are known to be small.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::vector<size_t> Graph<dir, Wei, Adj>::IntegerSSSP(Vertex vertex) const {
+  static_assert(std::is_integral_v<Weight>, "IntegerSSSP requires integer weights");
+  return BucketSSSP(vertex, Queue<size_t>(adj_list_.size()));
+}
+
+// Level-synchronous direction-optimizing BFS (Beamer et al.).
+// Top-down steps expand the frontier list, bottom-up steps let every
+// unvisited vertex look for a parent in the frontier bitmap.
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::ParallelBFS(Vertex vertex, size_t num_threads) const {
+  constexpr size_t kAlpha = 14ul;
+  constexpr size_t kBeta = 24ul;
+  constexpr size_t kWordBits = 64ul;
+  const size_t num_vertices = adj_list_.size();
+  const size_t num_words = (num_vertices + kWordBits - 1) / kWordBits;
+  num_threads = std::max(num_threads, 1ul);
+
+  std::vector<size_t> dist(num_vertices, static_cast<size_t>(-1));
+  std::vector<std::atomic<uint64_t>> visited(num_words);
+  std::vector<uint64_t> frontier_bits;
+  std::vector<uint64_t> next_bits;
+
+  // Bottom-up steps need incoming arcs, undirected graphs already store them
+  std::optional<Graph<dir, Wei, Adj>> transposed{};
+  const Adj* incoming = &adj_list_;
+
+  size_t unexplored_edges = 0ul;
+  for (Vertex curr = 0; curr < num_vertices; ++curr) {
+    unexplored_edges += adj_list_[curr].size();
+  }
+
+  dist[vertex] = 0;
+  visited[vertex / kWordBits] |= uint64_t{1} << (vertex % kWordBits);
+  unexplored_edges -= adj_list_[vertex].size();
+  std::vector<Vertex> frontier{vertex};
+  size_t frontier_size = 1ul;
+  size_t frontier_edges = adj_list_[vertex].size();
+  size_t prev_size = 0ul;
+  bool bottom_up = false;
+
+  std::vector<std::vector<Vertex>> local_next(num_threads);
+  for (size_t level = 0; frontier_size; ++level) {
+    if (!bottom_up && frontier_edges > unexplored_edges / kAlpha) {
+      bottom_up = true;
+      if constexpr (dir) {
+        if (!transposed.has_value()) {
+          transposed = Transposed();
+          incoming = &transposed->adj_list_;
         }
       }
-      if (dist[edge.dst] > dist[curr] + edge.weight) {
-        dist[edge.dst] = dist[curr] + edge.weight;
+      frontier_bits.assign(num_words, 0ull);
+      next_bits.assign(num_words, 0ull);
+      for (Vertex curr : frontier) {
+        frontier_bits[curr / kWordBits] |= uint64_t{1} << (curr % kWordBits);
       }
-      visited[edge.dst] = true;
+    } else if (bottom_up && frontier_size < prev_size && frontier_size < num_vertices / kBeta) {
+      bottom_up = false;
+      frontier.clear();
+      for (size_t word = 0; word < num_words; ++word) {
+        for (uint64_t bits = frontier_bits[word]; bits; bits &= bits - 1) {
+          frontier.emplace_back(word * kWordBits + __builtin_ctzll(bits));
+        }
+      }
+    }
+
+    std::atomic<size_t> next_size{0ul};
+    std::atomic<size_t> next_edges{0ul};
+    if (!bottom_up) {
+      detail::ParallelFor(
+          frontier.size(), num_threads,
+          [&](size_t thread_id, size_t begin, size_t end) {
+            size_t found_edges = 0ul;
+            auto& found = local_next[thread_id];
+            for (size_t index = begin; index < end; ++index) {
+              for (const auto& edge : adj_list_[frontier[index]]) {
+                Vertex next = edge.dst;
+                uint64_t bit = uint64_t{1} << (next % kWordBits);
+                auto& word = visited[next / kWordBits];
+                if ((word.load(std::memory_order_relaxed) & bit) || (word.fetch_or(bit) & bit)) {
+                  continue;
+                }
+                dist[next] = level + 1;
+                found.emplace_back(next);
+                found_edges += adj_list_[next].size();
+              }
+            }
+            next_edges += found_edges;
+          },
+          64ul);
+      frontier.clear();
+      for (auto& found : local_next) {
+        frontier.insert(frontier.end(), found.begin(), found.end());
+        found.clear();
+      }
+      next_size = frontier.size();
+    } else {
+      // Every thread owns whole bitmap words, so next_bits needs no atomics
+      detail::ParallelFor(
+          num_words, num_threads,
+          [&](size_t, size_t begin, size_t end) {
+            size_t found_vertices = 0ul;
+            size_t found_edges = 0ul;
+            for (size_t word = begin; word < end; ++word) {
+              uint64_t unvisited = ~visited[word].load(std::memory_order_relaxed);
+              if (word + 1 == num_words && num_vertices % kWordBits) {
+                unvisited &= (uint64_t{1} << (num_vertices % kWordBits)) - 1;
+              }
+              uint64_t found = 0ull;
+              for (; unvisited; unvisited &= unvisited - 1) {
+                Vertex curr = word * kWordBits + __builtin_ctzll(unvisited);
+                for (const auto& edge : (*incoming)[curr]) {
+                  if (frontier_bits[edge.dst / kWordBits] & (uint64_t{1} << (edge.dst % kWordBits))) {
+                    found |= uint64_t{1} << (curr % kWordBits);
+                    dist[curr] = level + 1;
+                    ++found_vertices;
+                    found_edges += adj_list_[curr].size();
+                    break;
+                  }
+                }
+              }
+              next_bits[word] = found;
+              visited[word].fetch_or(found, std::memory_order_relaxed);
+            }
+            next_size += found_vertices;
+            next_edges += found_edges;
+          },
+          16ul);
+      frontier_bits.swap(next_bits);
     }
+
+    prev_size = std::exchange(frontier_size, next_size);
+    frontier_edges = next_edges;
+    unexplored_edges -= frontier_edges;
   }
   return dist;
 }
 
-template <bool dir, class Wei>
-template <class Weight, EnifWeighted<Wei, Weight>>
-std::vector<size_t> Graph<dir, Wei>::BFS_0k(Vertex vertex, size_t k) const {
-  std::vector<size_t> dist(adj_list_.size(), static_cast<size_t>(-1));
+// MS-BFS (Then et al.): one traversal serves a batch of 64 * kWords
+// sources. Every vertex keeps a bitset of the sources that have seen it
+// and of those whose frontier it is on, so a vertex shared by several
+// searches is expanded once per level for all of them.
+// Calls report(vertex, level, lanes) for every vertex reached first by the
+// searches in `lanes` at that level.
+template <bool dir, class Wei, class Adj>
+template <size_t kWords, class Report>
+void Graph<dir, Wei, Adj>::MultiSourceBFSBatch(const Vertex* sources, size_t count, Report&& report) const {
+  using Lanes = std::array<uint64_t, kWords>;
+  constexpr size_t kWordBits = 64ul;
+  const size_t num_vertices = adj_list_.size();
+  auto any = [](const Lanes& lanes) {
+    uint64_t bits = 0;
+    for (size_t word = 0; word < kWords; ++word) {
+      bits |= lanes[word];
+    }
+    return bits != 0;
+  };
 
-  dist[vertex] = 0;
-  size_t num_on_que = 1;
-  size_t qind = 0;
-
-  std::vector<std::deque<Vertex>> ques(k + 1);
-  ques[0].emplace_front(vertex);
-  while (num_on_que) {
-    if (ques[qind].empty()) {
-      qind = (qind + 1) % (k + 1);
-      continue;
+  std::vector<Lanes> seen(num_vertices, Lanes{});
+  std::vector<Lanes> visit(num_vertices, Lanes{});
+  std::vector<Lanes> visit_next(num_vertices, Lanes{});
+  std::vector<Vertex> frontier;
+  for (size_t lane = 0; lane < count; ++lane) {
+    Vertex source = sources[lane];
+    if (!any(visit[source])) {
+      frontier.emplace_back(source);
     }
-    Vertex curr = ques[qind].front();
-    ques[qind].pop_front();
-    --num_on_que;
-    for (auto edge : adj_list_[curr]) {
-      Vertex vertex = edge.dst;
-      size_t weight = edge.weight;
-      if (dist[vertex] < dist[curr] + weight) {
-        continue;
+    seen[source][lane / kWordBits] |= uint64_t{1} << (lane % kWordBits);
+    visit[source][lane / kWordBits] |= uint64_t{1} << (lane % kWordBits);
+  }
+  for (Vertex vertex : frontier) {
+    report(vertex, 0ul, visit[vertex]);
+  }
+
+  std::vector<Vertex> touched;
+  for (size_t level = 1; !frontier.empty(); ++level) {
+    touched.clear();
+    for (Vertex vertex : frontier) {
+      const Lanes& lanes = visit[vertex];
+      for (const auto& edge : adj_list_[vertex]) {
+        Lanes& next = visit_next[edge.dst];
+        if (!any(next)) {
+          touched.emplace_back(edge.dst);
+        }
+        for (size_t word = 0; word < kWords; ++word) {
+          next[word] |= lanes[word];
+        }
+      }
+    }
+    for (Vertex vertex : frontier) {
+      visit[vertex] = Lanes{};
+    }
+    frontier.clear();
+    for (Vertex vertex : touched) {
+      Lanes fresh;
+      for (size_t word = 0; word < kWords; ++word) {
+        fresh[word] = visit_next[vertex][word] & ~seen[vertex][word];
+        seen[vertex][word] |= fresh[word];
+      }
+      visit_next[vertex] = Lanes{};
+      if (any(fresh)) {
+        visit[vertex] = fresh;
+        frontier.emplace_back(vertex);
+        report(vertex, level, fresh);
       }
-      ques[(qind + weight) % (k + 1)].emplace_back(vertex);
-      ++num_on_que;
-      dist[vertex] = dist[curr] + weight;
     }
   }
+}
+
+// Row i holds the distances from sources[i], -1 where unreachable
+template <bool dir, class Wei, class Adj>
+template <size_t kBatch>
+Matrix<size_t> Graph<dir, Wei, Adj>::MultiSourceBFS(const std::vector<Vertex>& sources) const {
+  static_assert(kBatch % 64ul == 0ul, "MS-BFS batches are whole 64-bit words");
+  Matrix<size_t> dist(sources.size(), adj_list_.size(), static_cast<size_t>(-1));
+  for (size_t first = 0; first < sources.size(); first += kBatch) {
+    const Vertex* batch = sources.data() + first;
+    size_t count = std::min(kBatch, sources.size() - first);
+    MultiSourceBFSBatch<kBatch / 64ul>(batch, count, [&](Vertex vertex, size_t level, const auto& lanes) {
+      for (size_t word = 0; word < lanes.size(); ++word) {
+        for (uint64_t bits = lanes[word]; bits; bits &= bits - 1) {
+          dist[first + word * 64ul + __builtin_ctzll(bits)][vertex] = level;
+        }
+      }
+    });
+  }
   return dist;
 }
 
-#endif
\ No newline at end of file
+// Eccentricity and closeness of many sources without keeping the
+// distance rows
+template <bool dir, class Wei, class Adj>
+template <size_t kBatch>
+std::vector<BFSStats> Graph<dir, Wei, Adj>::MultiSourceBFSStats(const std::vector<Vertex>& sources) const {
+  static_assert(kBatch % 64ul == 0ul, "MS-BFS batches are whole 64-bit words");
+  std::vector<BFSStats> stats(sources.size());
+  for (size_t first = 0; first < sources.size(); first += kBatch) {
+    size_t count = std::min(kBatch, sources.size() - first);
+    MultiSourceBFSBatch<kBatch / 64ul>(sources.data() + first, count, [&](Vertex, size_t level, const auto& lanes) {
+      for (size_t word = 0; word < lanes.size(); ++word) {
+        for (uint64_t bits = lanes[word]; bits; bits &= bits - 1) {
+          BFSStats& curr = stats[first + word * 64ul + __builtin_ctzll(bits)];
+          curr.eccentricity = level;
+          ++curr.reached;
+          curr.distance_sum += level;
+        }
+      }
+    });
+  }
+  return stats;
+}
+
+#endif
@@ -1,77 +1,117 @@
 #ifndef GRAPH_DFS_H_
 #define GRAPH_DFS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
 #include "./_graph_class.h"
 
-template <bool dir, class Wei>
-DFStimes Graph<dir, Wei>::DFS() const {
+// The DFS family runs on an explicit stack of frames, each holding the
+// cursor into its vertex's adjacency row, so deep graphs do not overflow
+// the call stack. Visiting order is that of the recursive formulation.
+template <bool dir, class Wei, class Adj>
+auto Graph<dir, Wei, Adj>::MakeFrame(Vertex vertex) const -> DfsFrame {
+  const auto& row = adj_list_[vertex];
+  return {vertex, row.begin(), row.end()};
+}
+
+template <bool dir, class Wei, class Adj>
+DFStimes Graph<dir, Wei, Adj>::DFS() const {
   DFStimes time(adj_list_.size(), std::make_pair<size_t, size_t>(0ul, 0ul));
   std::vector<Color> color(adj_list_.size(), Color::kWhite);
+  std::vector<DfsFrame> stack;
+  stack.reserve(adj_list_.size());
   size_t curr_time = 0ul;
   for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-    RecursiveDfsVisit(vertex, time, color, curr_time);
+    if (color[vertex] == Color::kWhite) {
+      DfsVisit(vertex, time, color, curr_time, stack);
+    }
   }
   return time;
 }
 
-template <bool dir, class Wei>
-void Graph<dir, Wei>::RecursiveDfsVisit(Vertex vertex, DFStimes& time, std::vector<Color>& color,
-                                        size_t& curr_time) const {
-  color[vertex] = Color::kGrey;
-  time[vertex].first = ++curr_time;
-  for (auto edge : adj_list_[vertex]) {
-    if (color[edge.dst] == Color::kWhite) {
-      RecursiveDfsVisit(edge.dst, time, color, curr_time);
+template <bool dir, class Wei, class Adj>
+void Graph<dir, Wei, Adj>::DfsVisit(Vertex root, DFStimes& time, std::vector<Color>& color, size_t& curr_time,
+                                    std::vector<DfsFrame>& stack) const {
+  auto enter = [&](Vertex vertex) {
+    color[vertex] = Color::kGrey;
+    time[vertex].first = ++curr_time;
+    stack.emplace_back(MakeFrame(vertex));
+  };
+  enter(root);
+  while (!stack.empty()) {
+    DfsFrame& frame = stack.back();
+    if (frame.next == frame.end) {
+      color[frame.vertex] = Color::kBlack;
+      time[frame.vertex].second = ++curr_time;
+      stack.pop_back();
+      continue;
+    }
+    Vertex child = (*frame.next).dst;
+    ++frame.next;
+    if (color[child] == Color::kWhite) {
+      enter(child);
     }
   }
-  color[vertex] = Color::kBlack;
-  time[vertex].second = ++curr_time;
 }
 
-template <bool dir, class Wei>
-bool Graph<dir, Wei>::HasCycle() const {
+// In undirected graphs the arc back to the DFS parent is skipped once,
+// so a second parallel edge still closes a cycle
+template <bool dir, class Wei, class Adj>
+bool Graph<dir, Wei, Adj>::HasCycle() const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
   std::vector<Color> color(adj_list_.size(), Color::kWhite);
-  std::vector<Vertex> parent(adj_list_.size(), static_cast<size_t>(-1));
-  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-    if (color[vertex] == Color::kWhite && RecursiveHasCycle(vertex, color, parent)) {
-      return true;
+  std::vector<Vertex> parent(adj_list_.size(), kNone);
+  std::vector<bool> parent_skipped(adj_list_.size(), false);
+  std::vector<DfsFrame> stack;
+  for (Vertex root = 0; root < adj_list_.size(); ++root) {
+    if (color[root] != Color::kWhite) {
+      continue;
     }
-  }
-  return false;
-}
-
-template <bool dir, class Wei>
-bool Graph<dir, Wei>::RecursiveHasCycle(Vertex vertex, std::vector<Color>& color, std::vector<Vertex>& parent) const {
-  color[vertex] = Color::kGrey;
-  for (auto edge : adj_list_[vertex]) {
-    if (color[edge.dst] == Color::kGrey) {
-      if constexpr (dir) {
-        return true;
-      } else {
-        if (parent[vertex] != edge.dst) {
-          return true;
+    color[root] = Color::kGrey;
+    stack.emplace_back(MakeFrame(root));
+    while (!stack.empty()) {
+      DfsFrame& frame = stack.back();
+      Vertex vertex = frame.vertex;
+      if (frame.next == frame.end) {
+        color[vertex] = Color::kBlack;
+        stack.pop_back();
+        continue;
+      }
+      Vertex child = (*frame.next).dst;
+      ++frame.next;
+      if (color[child] == Color::kGrey) {
+        if constexpr (!dir) {
+          if (child == parent[vertex] && !parent_skipped[vertex]) {
+            parent_skipped[vertex] = true;
+            continue;
+          }
         }
+        return true;
+      }
+      if (color[child] == Color::kWhite) {
+        parent[child] = vertex;
+        color[child] = Color::kGrey;
+        stack.emplace_back(MakeFrame(child));
       }
-    }
-    parent[edge.dst] = vertex;
-    if (color[edge.dst] == Color::kWhite && RecursiveHasCycle(edge.dst, color, parent)) {
-      return true;
     }
   }
-  color[vertex] = Color::kBlack;
   return false;
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <bool directed, EnifDirected<dir, directed>>
-std::pair<bool, std::vector<Vertex>> Graph<dir, Wei>::TopSort(bool do_reverse) const {
+std::pair<bool, std::vector<Vertex>> Graph<dir, Wei, Adj>::TopSort(bool do_reverse) const {
   bool acyclic = true;
   std::vector<Color> color(adj_list_.size(), Color::kWhite);
   std::vector<Vertex> reverse_order{};
+  std::vector<DfsFrame> stack;
+  stack.reserve(adj_list_.size());
   reverse_order.reserve(adj_list_.size());
   for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
     if (color[vertex] == Color::kWhite) {
-      acyclic = RecursiveTopSort(vertex, color, reverse_order) && acyclic;
+      acyclic = TopSortVisit(vertex, color, reverse_order, stack) && acyclic;
     }
   }
   if (do_reverse) {
@@ -81,40 +121,326 @@ std::pair<bool, std::vector<Vertex>> Graph<dir, Wei>::TopSort(bool do_reverse) c
   }
 }
 
-template <bool dir, class Wei>
-bool Graph<dir, Wei>::RecursiveTopSort(Vertex vertex, std::vector<Color>& color,
-                                       std::vector<Vertex>& reverse_order) const {
+template <bool dir, class Wei, class Adj>
+bool Graph<dir, Wei, Adj>::TopSortVisit(Vertex root, std::vector<Color>& color, std::vector<Vertex>& reverse_order,
+                                        std::vector<DfsFrame>& stack) const {
   bool acyclic = true;
-  color[vertex] = Color::kGrey;
-  for (auto edge : adj_list_[vertex]) {
-    if (color[edge.dst] == Color::kWhite) {
-      acyclic = RecursiveTopSort(edge.dst, color, reverse_order) && acyclic;
-    } else if (color[edge.dst] == Color::kGrey) {
+  color[root] = Color::kGrey;
+  stack.emplace_back(MakeFrame(root));
+  while (!stack.empty()) {
+    DfsFrame& frame = stack.back();
+    if (frame.next == frame.end) {
+      color[frame.vertex] = Color::kBlack;
+      reverse_order.emplace_back(frame.vertex);
+      stack.pop_back();
+      continue;
+    }
+    Vertex child = (*frame.next).dst;
+    ++frame.next;
+    if (color[child] == Color::kWhite) {
+      color[child] = Color::kGrey;
+      stack.emplace_back(MakeFrame(child));
+    } else if (color[child] == Color::kGrey) {
       acyclic = false;
     }
   }
-  color[vertex] = Color::kBlack;
-  reverse_order.emplace_back(vertex);
   return acyclic;
 }
 
-template <bool dir, class Wei>
-std::vector<std::vector<Vertex>> Graph<dir, Wei>::SCC() const {
+// Components in topological order of the condensation, for undirected
+// graphs these are the connected components
+template <bool dir, class Wei, class Adj>
+std::vector<std::vector<Vertex>> Graph<dir, Wei, Adj>::SCC() const {
+  std::vector<size_t> component = SCCIds();
+  size_t num_components = 0ul;
+  for (size_t id : component) {
+    num_components = std::max(num_components, id + 1);
+  }
+  std::vector<std::vector<Vertex>> result(num_components);
+  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+    result[num_components - 1 - component[vertex]].emplace_back(vertex);
+  }
+  return result;
+}
+
+// Single-pass Tarjan. Ids are assigned in reverse topological order of the
+// condensation: arcs between components go from larger ids to smaller.
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::SCCIds() const {
+  std::vector<size_t> component(adj_list_.size(), static_cast<size_t>(-1));
+  TarjanSCC(component, 0ul);
+  return component;
+}
+
+// Tarjan over the vertices whose component is still unassigned, the
+// others are treated as removed. Returns the next free component id.
+template <bool dir, class Wei, class Adj>
+size_t Graph<dir, Wei, Adj>::TarjanSCC(std::vector<size_t>& component, size_t next_id) const {
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  std::vector<size_t> index(adj_list_.size(), kNone);
+  std::vector<size_t> low(adj_list_.size());
+  std::vector<Vertex> open;
+  std::vector<DfsFrame> stack;
+  size_t curr_index = 0ul;
+  auto enter = [&](Vertex vertex) {
+    index[vertex] = low[vertex] = curr_index++;
+    open.emplace_back(vertex);
+    stack.emplace_back(MakeFrame(vertex));
+  };
+
+  for (Vertex root = 0; root < adj_list_.size(); ++root) {
+    if (component[root] != kNone || index[root] != kNone) {
+      continue;
+    }
+    enter(root);
+    while (!stack.empty()) {
+      DfsFrame& frame = stack.back();
+      Vertex vertex = frame.vertex;
+      if (frame.next != frame.end) {
+        Vertex child = (*frame.next).dst;
+        ++frame.next;
+        if (component[child] != kNone) {
+          continue;
+        }
+        if (index[child] == kNone) {
+          enter(child);
+        } else {
+          low[vertex] = std::min(low[vertex], index[child]);
+        }
+        continue;
+      }
+
+      stack.pop_back();
+      if (low[vertex] == index[vertex]) {
+        Vertex member;
+        do {
+          member = open.back();
+          open.pop_back();
+          component[member] = next_id;
+        } while (member != vertex);
+        ++next_id;
+      }
+      if (!stack.empty()) {
+        Vertex parent = stack.back().vertex;
+        low[parent] = std::min(low[parent], low[vertex]);
+      }
+    }
+  }
+  return next_id;
+}
+
+// Forward-Backward-Trim: repeatedly peels off vertices without incoming or
+// outgoing arcs inside the remaining graph (each is its own component),
+// takes the giant component as the intersection of the forward and
+// backward reachable sets of a high-degree pivot, trims again and leaves
+// the small remainder to sequential Tarjan. Trimming and both searches
+// are level-synchronous and run on a thread pool. Ids carry no order.
+template <bool dir, class Wei, class Adj>
+std::vector<size_t> Graph<dir, Wei, Adj>::ParallelSCC(size_t num_threads) const {
+  // Undirected graphs already store the incoming arcs
   if constexpr (dir) {
-    auto [acyclic, topsort] = TopSort(false);
-    auto g_t = Transposed();
-    std::vector<std::vector<Vertex>> result;
-    std::vector<Color> color(adj_list_.size(), Color::kWhite);
-    for (auto it = topsort.rbegin(); it != topsort.rend(); ++it) {
-      if (color[*it] == Color::kWhite) {
-        result.emplace_back();
-        g_t.RecursiveTopSort(*it, color, result.back());
+    std::vector<Edge<Wei>> arcs;
+    for (const auto& curr_edges : adj_list_) {
+      for (auto edge : curr_edges) {
+        std::swap(edge.src, edge.dst);
+        arcs.emplace_back(edge);
       }
     }
-    return result;
+    return ForwardBackwardTrim(CSRAdjacency<Wei>(adj_list_.size(), arcs), num_threads);
   } else {
-    // TODO
+    return ForwardBackwardTrim(adj_list_, num_threads);
+  }
+}
+
+template <bool dir, class Wei, class Adj>
+template <class Incoming>
+std::vector<size_t> Graph<dir, Wei, Adj>::ForwardBackwardTrim(const Incoming& incoming, size_t num_threads) const {
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  const size_t num_vertices = adj_list_.size();
+  std::vector<size_t> component(num_vertices, kNone);
+  if (num_vertices == 0) {
+    return component;
+  }
+
+  detail::ThreadPool pool(std::max(num_threads, 1ul));
+  std::vector<std::vector<Vertex>> local(pool.NumThreads());
+  auto gather = [&local](std::vector<Vertex>& out) {
+    out.clear();
+    for (auto& part : local) {
+      out.insert(out.end(), part.begin(), part.end());
+      part.clear();
+    }
+  };
+  size_t next_id = 0ul;
+
+  auto has_live_arc = [&component](const auto& row, Vertex vertex) {
+    for (const auto& edge : row) {
+      if (edge.dst != vertex && component[edge.dst] == kNone) {
+        return true;
+      }
+    }
+    return false;
+  };
+  // Only neighbours of trimmed vertices can become trimmable
+  std::vector<size_t> candidate_round(num_vertices, kNone);
+  size_t round = 0ul;
+  auto trim = [&](std::vector<Vertex> candidates) {
+    std::vector<Vertex> trimmed;
+    for (; !candidates.empty(); ++round) {
+      pool.Run(
+          candidates.size(),
+          [&](size_t thread_id, size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+              Vertex vertex = candidates[index];
+              if (!has_live_arc(adj_list_[vertex], vertex) || !has_live_arc(incoming[vertex], vertex)) {
+                local[thread_id].emplace_back(vertex);
+              }
+            }
+          },
+          256ul);
+      gather(trimmed);
+      for (Vertex vertex : trimmed) {
+        component[vertex] = next_id++;
+      }
+      candidates.clear();
+      for (Vertex vertex : trimmed) {
+        auto enqueue = [&](const auto& row) {
+          for (const auto& edge : row) {
+            if (component[edge.dst] == kNone && candidate_round[edge.dst] != round) {
+              candidate_round[edge.dst] = round;
+              candidates.emplace_back(edge.dst);
+            }
+          }
+        };
+        enqueue(adj_list_[vertex]);
+        enqueue(incoming[vertex]);
+      }
+    }
+  };
+
+  // Marks everything reachable from `start` over `arcs` among unassigned
+  // vertices that already carry all bits of `within`
+  std::vector<std::atomic<uint8_t>> mark(num_vertices);
+  auto reach = [&](Vertex start, const auto& arcs, uint8_t bit, uint8_t within) {
+    mark[start].fetch_or(bit);
+    std::vector<Vertex> frontier{start};
+    while (!frontier.empty()) {
+      pool.Run(
+          frontier.size(),
+          [&](size_t thread_id, size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index) {
+              for (const auto& edge : arcs[frontier[index]]) {
+                Vertex next = edge.dst;
+                uint8_t state = mark[next].load(std::memory_order_relaxed);
+                if (component[next] != kNone || (state & bit) || (state & within) != within) {
+                  continue;
+                }
+                if (!(mark[next].fetch_or(bit) & bit)) {
+                  local[thread_id].emplace_back(next);
+                }
+              }
+            }
+          },
+          64ul);
+      gather(frontier);
+    }
+  };
+
+  std::vector<Vertex> all(num_vertices);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    all[vertex] = vertex;
+  }
+  trim(all);
+
+  Vertex pivot = kNone;
+  size_t best_degree = 0ul;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    size_t degree = (adj_list_[vertex].size() + 1) * (incoming[vertex].size() + 1);
+    if (component[vertex] == kNone && (pivot == kNone || degree > best_degree)) {
+      pivot = vertex;
+      best_degree = degree;
+    }
+  }
+  if (pivot != kNone) {
+    constexpr uint8_t kForward = 1;
+    constexpr uint8_t kBackward = 2;
+    reach(pivot, adj_list_, kForward, 0);
+    reach(pivot, incoming, kBackward, kForward);
+    std::vector<Vertex> rest;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (mark[vertex].load(std::memory_order_relaxed) == (kForward | kBackward)) {
+        component[vertex] = next_id;
+      }
+    }
+    ++next_id;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (component[vertex] == kNone) {
+        rest.emplace_back(vertex);
+      }
+    }
+    trim(std::move(rest));
+  }
+
+  TarjanSCC(component, next_id);
+  return component;
+}
+
+// Condensation: component ids follow a topological order of the result,
+// so arcs only go from smaller to larger ids. Parallel arcs between two
+// components are merged, weighted ones keep the smallest weight.
+template <bool dir, class Wei, class Adj>
+template <bool directed, EnifDirected<dir, directed>>
+std::pair<Graph<true, Wei>, std::vector<size_t>> Graph<dir, Wei, Adj>::Condense() const {
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  const size_t num_vertices = adj_list_.size();
+  std::vector<size_t> component = SCCIds();
+  size_t num_components = 0ul;
+  for (size_t id : component) {
+    num_components = std::max(num_components, id + 1);
+  }
+  std::vector<size_t> members_offset(num_components + 1, 0ul);
+  for (size_t& id : component) {
+    id = num_components - 1 - id;
+    ++members_offset[id + 1];
+  }
+  for (size_t id = 0; id < num_components; ++id) {
+    members_offset[id + 1] += members_offset[id];
+  }
+  std::vector<Vertex> members(num_vertices);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    members[members_offset[component[vertex]]++] = vertex;
+  }
+  std::rotate(members_offset.rbegin(), members_offset.rbegin() + 1, members_offset.rend());
+  members_offset[0] = 0ul;
+
+  // arc_index[c] is the position of the arc to c among the current
+  // component's arcs, valid while seen_from[c] is the current component
+  std::vector<Edge<Wei>> arcs;
+  std::vector<size_t> seen_from(num_components, kNone);
+  std::vector<size_t> arc_index(num_components);
+  for (size_t id = 0; id < num_components; ++id) {
+    for (size_t member = members_offset[id]; member < members_offset[id + 1]; ++member) {
+      for (const auto& edge : adj_list_[members[member]]) {
+        size_t dst = component[edge.dst];
+        if (dst == id) {
+          continue;
+        }
+        if (seen_from[dst] != id) {
+          seen_from[dst] = id;
+          arc_index[dst] = arcs.size();
+          if constexpr (std::is_same_v<Wei, void>) {
+            arcs.emplace_back(id, dst);
+          } else {
+            arcs.emplace_back(id, dst, edge.weight);
+          }
+        } else if constexpr (!std::is_same_v<Wei, void>) {
+          auto& weight = arcs[arc_index[dst]].weight;
+          weight = std::min(weight, edge.weight);
+        }
+      }
+    }
   }
+  return {Graph<true, Wei>(num_components, arcs), std::move(component)};
 }
 
-#endif
\ No newline at end of file
+#endif
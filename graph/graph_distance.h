@@ -2,93 +2,348 @@
 #define GRAPH_DISTANCE_H_
 
 #include "./_graph_class.h"
+#include <algorithm>
+#include <functional>
 #include <utility>
 #include <optional>
+#include <deque>
 #include <queue>
 #include <limits>
-#include "../heap/fibonacci_heap.h"
+#include <map>
+#include <type_traits>
+#include "../heap/lazy_binary_heap.h"
+#include "../heap/d_ary_heap.h"
+#include "../heap/pairing_heap.h"
+#include "../heap/radix_heap.h"
+#include "./_graph_min_plus.h"
 
-template <class Weight>
-bool operator<(const std::pair<std::optional<Weight>, Vertex>& lhs,
-               const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  if (lhs.first.has_value() && rhs.first.has_value()) {
-    if (*lhs.first != *rhs.first) {
-      return *lhs.first < *rhs.first;
+// Dijkstra takes the priority queue as a policy: Queue<Weight>(n) must
+// provide Empty(), Push(vertex, key) and ExtractMin() -> {key, vertex}.
+// Push either decreases the key (DAryHeap, PairingHeap) or inserts a
+// duplicate (LazyBinaryHeap, RadixHeap), stale entries are skipped on
+// extraction. Vertices enter the queue only when first reached.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::vector<std::optional<Weight>> Graph<dir, Wei, Adj>::Dijkstra(Vertex start) const {
+  std::vector<std::optional<Weight>> answer(adj_list_.size());
+  std::vector<bool> settled(adj_list_.size(), false);
+  Queue<Weight> queue(adj_list_.size());
+  answer[start] = 0;
+  queue.Push(start, 0);
+
+  while (!queue.Empty()) {
+    auto [weight, vertex] = queue.ExtractMin();
+    if (settled[vertex]) {
+      continue;
+    }
+    settled[vertex] = true;
+    for (const auto& edge : adj_list_[vertex]) {
+      if (settled[edge.dst]) {
+        continue;
+      }
+      Weight new_weight = weight + edge.weight;
+      if (!answer[edge.dst].has_value() || new_weight < *answer[edge.dst]) {
+        answer[edge.dst] = new_weight;
+        queue.Push(edge.dst, new_weight);
+      }
     }
-    return lhs.second < rhs.second;
-  }
-  if (!lhs.first.has_value() && rhs.first.has_value()) {
-    return false;
-  }
-  if (lhs.first.has_value() && !rhs.first.has_value()) {
-    return true;
   }
-  return lhs.second < rhs.second;
-}
-template <class Weight>
-bool operator==(const std::pair<std::optional<Weight>, Vertex>& lhs,
-                const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  return !(lhs < rhs) && !(rhs < lhs);
-}
-template <class Weight>
-bool operator!=(const std::pair<std::optional<Weight>, Vertex>& lhs,
-                const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  return !(lhs == rhs);
+  return answer;
 }
-template <class Weight>
-bool operator>=(const std::pair<std::optional<Weight>, Vertex>& lhs,
-                const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  return !(lhs < rhs);
+
+// Dijkstra stopped as soon as the target is settled
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::optional<Path<Weight>> Graph<dir, Wei, Adj>::ShortestPath(Vertex source, Vertex target) const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
+  std::vector<std::optional<Weight>> dist(adj_list_.size());
+  std::vector<Vertex> parent(adj_list_.size(), kNone);
+  std::vector<bool> settled(adj_list_.size(), false);
+  Queue<Weight> queue(adj_list_.size());
+  size_t num_settled = 0ul;
+  dist[source] = 0;
+  queue.Push(source, 0);
+
+  while (!queue.Empty()) {
+    auto [weight, vertex] = queue.ExtractMin();
+    if (settled[vertex]) {
+      continue;
+    }
+    settled[vertex] = true;
+    ++num_settled;
+    if (vertex == target) {
+      std::vector<Vertex> path;
+      for (Vertex curr = target; curr != kNone; curr = parent[curr]) {
+        path.emplace_back(curr);
+      }
+      return Path<Weight>{weight, {path.rbegin(), path.rend()}, num_settled};
+    }
+    for (const auto& edge : adj_list_[vertex]) {
+      if (settled[edge.dst]) {
+        continue;
+      }
+      Weight new_weight = weight + edge.weight;
+      if (!dist[edge.dst].has_value() || new_weight < *dist[edge.dst]) {
+        dist[edge.dst] = new_weight;
+        parent[edge.dst] = vertex;
+        queue.Push(edge.dst, new_weight);
+      }
+    }
+  }
+  return {};
 }
-template <class Weight>
-bool operator>(const std::pair<std::optional<Weight>, Vertex>& lhs,
-               const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  return rhs < lhs;
+
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::optional<Path<Weight>> Graph<dir, Wei, Adj>::BidirectionalShortestPath(Vertex source, Vertex target) const {
+  if constexpr (dir) {
+    return BidirectionalShortestPath<Queue>(source, target, Transposed());
+  } else {
+    return BidirectionalShortestPath<Queue>(source, target, *this);
+  }
 }
-template <class Weight>
-bool operator<=(const std::pair<std::optional<Weight>, Vertex>& lhs,
-                const std::pair<std::optional<Weight>, Vertex>& rhs) {
-  return !(rhs < lhs);
+
+// Forward search on this graph, backward search on `transposed`, always
+// advancing the side with the smaller queue. Stops once the keys last
+// settled on both sides add up to at least the best meeting distance.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::optional<Path<Weight>> Graph<dir, Wei, Adj>::BidirectionalShortestPath(
+    Vertex source, Vertex target, const Graph<dir, Wei, Adj>& transposed) const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
+  struct Side {
+    const Adj& adj_list;
+    std::vector<std::optional<Weight>> dist;
+    std::vector<Vertex> parent;
+    std::vector<bool> settled;
+    Queue<Weight> queue;
+    Weight last_key;
+  };
+  const size_t num_vertices = adj_list_.size();
+  Side sides[2] = {
+      {adj_list_, std::vector<std::optional<Weight>>(num_vertices), std::vector<Vertex>(num_vertices, kNone),
+       std::vector<bool>(num_vertices, false), Queue<Weight>(num_vertices), 0},
+      {transposed.adj_list_, std::vector<std::optional<Weight>>(num_vertices), std::vector<Vertex>(num_vertices, kNone),
+       std::vector<bool>(num_vertices, false), Queue<Weight>(num_vertices), 0},
+  };
+  sides[0].dist[source] = 0;
+  sides[0].queue.Push(source, 0);
+  sides[1].dist[target] = 0;
+  sides[1].queue.Push(target, 0);
+
+  std::optional<Weight> best{};
+  Vertex meeting = kNone;
+  if (source == target) {
+    best = 0;
+    meeting = source;
+  }
+  auto try_meet = [&](Vertex vertex) {
+    if (sides[0].dist[vertex].has_value() && sides[1].dist[vertex].has_value()) {
+      Weight candidate = *sides[0].dist[vertex] + *sides[1].dist[vertex];
+      if (!best.has_value() || candidate < *best) {
+        best = candidate;
+        meeting = vertex;
+      }
+    }
+  };
+
+  size_t num_settled = 0ul;
+  while (!sides[0].queue.Empty() && !sides[1].queue.Empty()) {
+    if (best.has_value() && !(sides[0].last_key + sides[1].last_key < *best)) {
+      break;
+    }
+    Side& side = sides[sides[1].queue.Size() < sides[0].queue.Size() ? 1 : 0];
+    auto [weight, vertex] = side.queue.ExtractMin();
+    if (side.settled[vertex]) {
+      continue;
+    }
+    side.settled[vertex] = true;
+    side.last_key = weight;
+    ++num_settled;
+    for (const auto& edge : side.adj_list[vertex]) {
+      if (side.settled[edge.dst]) {
+        continue;
+      }
+      Weight new_weight = weight + edge.weight;
+      if (!side.dist[edge.dst].has_value() || new_weight < *side.dist[edge.dst]) {
+        side.dist[edge.dst] = new_weight;
+        side.parent[edge.dst] = vertex;
+        side.queue.Push(edge.dst, new_weight);
+      }
+      try_meet(edge.dst);
+    }
+  }
+
+  if (!best.has_value()) {
+    return {};
+  }
+  std::vector<Vertex> path;
+  for (Vertex curr = meeting; curr != kNone; curr = sides[0].parent[curr]) {
+    path.emplace_back(curr);
+  }
+  std::reverse(path.begin(), path.end());
+  for (Vertex curr = sides[1].parent[meeting]; curr != kNone; curr = sides[1].parent[curr]) {
+    path.emplace_back(curr);
+  }
+  return Path<Weight>{*best, std::move(path), num_settled};
 }
 
-template <bool dir, class Wei>
-template <class Weight, EnifWeighted<Wei, Weight>>
-std::vector<std::optional<Weight>> Graph<dir, Wei>::Dijkstra(Vertex start) const {
-  std::vector<std::optional<Weight>> answer(adj_list_.size());
-  answer[start] = 0;
-  using FibHeap = FibonacciHeap<std::pair<std::optional<Weight>, Vertex>>;
-  FibHeap heap;
-  std::vector<typename FibHeap::Iterator> it_vec;
-  it_vec.reserve(adj_list_.size());
-  for (Vertex v = 0; v < adj_list_.size(); ++v) {
-    it_vec.emplace_back(heap.Emplace(answer[v], v));
-  }
-
-  while (heap.Size()) {
-    auto [weight, vertex] = heap.ExtractMin();
-    it_vec[vertex] = heap.end();
-    if (!weight.has_value()) {
+// A* search ordered by dist(v) + heuristic(v). The heuristic must be
+// admissible (never overestimate the remaining distance); vertices are
+// reopened when a shorter route is found, so it need not be consistent.
+// RadixHeap may only be used with a consistent heuristic.
+// Path::num_settled counts expansions, reopened vertices included.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Heuristic, class Weight, EnifWeighted<Wei, Weight>>
+std::optional<Path<Weight>> Graph<dir, Wei, Adj>::AStar(Vertex source, Vertex target, Heuristic&& heuristic) const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
+  std::vector<std::optional<Weight>> dist(adj_list_.size());
+  std::vector<Vertex> parent(adj_list_.size(), kNone);
+  Queue<Weight> queue(adj_list_.size());
+  size_t num_expanded = 0ul;
+  dist[source] = 0;
+  queue.Push(source, static_cast<Weight>(heuristic(source)));
+
+  while (!queue.Empty()) {
+    auto [key, vertex] = queue.ExtractMin();
+    if (*dist[vertex] + static_cast<Weight>(heuristic(vertex)) < key) {
       continue;
     }
+    ++num_expanded;
+    if (vertex == target) {
+      std::vector<Vertex> path;
+      for (Vertex curr = target; curr != kNone; curr = parent[curr]) {
+        path.emplace_back(curr);
+      }
+      return Path<Weight>{*dist[target], {path.rbegin(), path.rend()}, num_expanded};
+    }
     for (const auto& edge : adj_list_[vertex]) {
-      if (it_vec[edge.dst] == heap.end()) {
-        continue;
+      Weight new_weight = *dist[vertex] + edge.weight;
+      if (!dist[edge.dst].has_value() || new_weight < *dist[edge.dst]) {
+        dist[edge.dst] = new_weight;
+        parent[edge.dst] = vertex;
+        queue.Push(edge.dst, new_weight + static_cast<Weight>(heuristic(edge.dst)));
       }
-      Weight new_weight = *weight + edge.weight;
-      if (!answer[edge.dst].has_value() || new_weight < *answer[edge.dst]) {
-        answer[edge.dst] = new_weight;
-        heap.DecreaseKey(it_vec[edge.dst], {new_weight, edge.dst});
+    }
+  }
+  return {};
+}
+
+// Delta-stepping (Meyer & Sanders) for non-negative weights. Vertices are
+// kept in buckets of width delta; a bucket is emptied by repeated phases
+// relaxing light edges (weight <= delta), then heavy edges of everything
+// settled in it are relaxed once. Each phase first generates relaxation
+// requests in parallel, then every thread applies the requests for the
+// vertices it owns (vertex % num_threads), so no atomics are needed.
+// Only non-empty buckets are stored, ordered by index, so a long arc
+// skips the empty range instead of allocating it. Returns nothing when
+// delta is not positive.
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::optional<std::vector<std::optional<Weight>>> Graph<dir, Wei, Adj>::DeltaStepping(
+    Vertex start, std::common_type_t<Weight> delta, size_t num_threads) const {
+  using Request = std::pair<Vertex, Weight>;
+  if (!(Weight{} < delta)) {
+    return {};
+  }
+  const size_t num_vertices = adj_list_.size();
+  detail::ThreadPool pool(num_threads);
+  num_threads = pool.NumThreads();
+
+  std::vector<std::optional<Weight>> dist(num_vertices);
+  std::map<size_t, std::vector<Vertex>> buckets;
+  auto bucket_of = [delta](Weight weight) { return static_cast<size_t>(weight / delta); };
+  auto insert = [&buckets, &bucket_of](Vertex vertex, Weight weight) {
+    buckets[bucket_of(weight)].emplace_back(vertex);
+  };
+
+  // requests[producer][owner], inserted[owner]
+  std::vector<std::vector<std::vector<Request>>> requests(num_threads, std::vector<std::vector<Request>>(num_threads));
+  std::vector<std::vector<Vertex>> inserted(num_threads);
+  std::vector<char> pending(num_vertices, 0);  // queued in the bucket of its current distance
+  auto relax = [&](const std::vector<Vertex>& sources, bool light) {
+    pool.Run(
+        sources.size(),
+        [&](size_t thread_id, size_t begin, size_t end) {
+          auto& outgoing = requests[thread_id];
+          for (size_t index = begin; index < end; ++index) {
+            Vertex vertex = sources[index];
+            for (const auto& edge : adj_list_[vertex]) {
+              if ((edge.weight <= delta) == light) {
+                outgoing[edge.dst % num_threads].emplace_back(edge.dst, *dist[vertex] + edge.weight);
+              }
+            }
+          }
+        },
+        256ul);
+    pool.Run(
+        num_threads,
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t owner = begin; owner < end; ++owner) {
+            for (auto& outgoing : requests) {
+              for (const auto& [vertex, weight] : outgoing[owner]) {
+                if (!dist[vertex].has_value() || weight < *dist[vertex]) {
+                  if (!dist[vertex].has_value() || bucket_of(weight) != bucket_of(*dist[vertex]) ||
+                      !pending[vertex]) {
+                    pending[vertex] = 1;
+                    inserted[owner].emplace_back(vertex);
+                  }
+                  dist[vertex] = weight;
+                }
+              }
+              outgoing[owner].clear();
+            }
+          }
+        },
+        1ul);
+    for (auto& vertices : inserted) {
+      for (Vertex vertex : vertices) {
+        insert(vertex, *dist[vertex]);
       }
+      vertices.clear();
     }
+  };
+
+  dist[start] = 0;
+  insert(start, 0);
+  std::vector<char> in_frontier(num_vertices, 0);
+  std::vector<char> settled(num_vertices, 0);
+  std::vector<Vertex> frontier;
+  std::vector<Vertex> removed;
+  while (!buckets.empty()) {
+    auto bucket = buckets.begin();
+    const size_t index = bucket->first;
+    while (!bucket->second.empty()) {
+      frontier.clear();
+      for (Vertex vertex : bucket->second) {
+        if (!in_frontier[vertex] && bucket_of(*dist[vertex]) == index) {
+          pending[vertex] = 0;
+          in_frontier[vertex] = 1;
+          frontier.emplace_back(vertex);
+        }
+      }
+      bucket->second.clear();
+      for (Vertex vertex : frontier) {
+        in_frontier[vertex] = 0;
+        if (!settled[vertex]) {
+          settled[vertex] = 1;
+          removed.emplace_back(vertex);
+        }
+      }
+      relax(frontier, true);
+    }
+    relax(removed, false);
+    removed.clear();
+    buckets.erase(bucket);
   }
-  return answer;
+  return dist;
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <class Weight, EnifWeighted<Wei, Weight>>
-std::pair<bool, std::vector<Weight>> Graph<dir, Wei>::BellmanFord(Vertex start) const {
+std::pair<bool, std::vector<Weight>> Graph<dir, Wei, Adj>::BellmanFord(Vertex start) const {
   constexpr Weight plus_inf = std::numeric_limits<Weight>::max();
-  // constexpr Weight minus_inf = std::numeric_limits<Weight>::lowest();
+  constexpr Weight minus_inf = std::numeric_limits<Weight>::lowest();
 
   // Dist initialization
   std::vector<Weight> dist;
@@ -99,8 +354,10 @@ std::pair<bool, std::vector<Weight>> Graph<dir, Wei>::BellmanFord(Vertex start)
     dist[start] = 0;
   }
 
-  // Bellman - Ford
-  for (size_t i = 1; i < adj_list_.size(); ++i) {
+  // Bellman - Ford, stops after the first pass that changes nothing
+  bool changed = true;
+  for (size_t i = 1; changed && i < adj_list_.size(); ++i) {
+    changed = false;
     for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
       if (dist[vertex] == plus_inf) {
         continue;
@@ -109,64 +366,277 @@ std::pair<bool, std::vector<Weight>> Graph<dir, Wei>::BellmanFord(Vertex start)
         Weight new_dist = dist[vertex] + edge.weight;
         if (dist[edge.dst] == plus_inf || dist[edge.dst] > new_dist) {
           dist[edge.dst] = new_dist;
+          changed = true;
+        }
+      }
+    }
+  }
+  if (!changed) {
+    return {true, std::move(dist)};
+  }
+
+  // Detect negative vertices
+  std::vector<Vertex> negative_vertices;
+  for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+    if (dist[vertex] == plus_inf) {
+      continue;
+    }
+    for (const auto& edge : adj_list_[vertex]) {
+      Weight new_dist = dist[vertex] + edge.weight;
+      if (dist[edge.dst] > new_dist) {
+        negative_vertices.emplace_back(edge.dst);
+      }
+    }
+  }
+
+  // Assign -inf
+  std::vector<Vertex> stack;
+  for (Vertex neg_start : negative_vertices) {
+    if (dist[neg_start] == minus_inf) {
+      continue;
+    }
+    stack.emplace_back(neg_start);
+    dist[neg_start] = minus_inf;
+    while (!stack.empty()) {
+      Vertex vertex = stack.back();
+      stack.pop_back();
+      for (const auto& edge : adj_list_[vertex]) {
+        if (dist[edge.dst] != minus_inf) {
+          stack.emplace_back(edge.dst);
+          dist[edge.dst] = minus_inf;
+        }
+      }
+    }
+  }
+  return {negative_vertices.empty(), std::move(dist)};
+}
+
+// Queue-based Bellman-Ford (SPFA) with the Small Label First and Large
+// Label Last heuristics. start == Size() means a virtual source joined to
+// every vertex by a zero-weight edge. A vertex whose shortest-path tree
+// depth reaches Size() edges is reachable from a negative cycle; it is no
+// longer queued, so the search always terminates.
+// Returns distances and the sorted vertices on or reachable from a
+// negative cycle, whose distances are left empty.
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::pair<std::vector<std::optional<Weight>>, std::vector<Vertex>> Graph<dir, Wei, Adj>::SPFA(Vertex start) const {
+  const size_t num_vertices = adj_list_.size();
+  std::vector<std::optional<Weight>> dist(num_vertices);
+  std::vector<size_t> depth(num_vertices, 0ul);
+  std::vector<bool> in_queue(num_vertices, false);
+  std::vector<bool> on_cycle(num_vertices, false);
+  std::vector<Vertex> cycle_witnesses;
+  std::deque<Vertex> queue;
+  Weight queued_sum = 0;
+
+  if (start == num_vertices) {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      dist[vertex] = 0;
+      in_queue[vertex] = true;
+      queue.emplace_back(vertex);
+    }
+  } else {
+    dist[start] = 0;
+    in_queue[start] = true;
+    queue.emplace_back(start);
+  }
+
+  // Compared with the average rather than dist * size, which can overflow.
+  // For integers d > sum / size holds exactly when d > floor(sum / size).
+  auto above_average = [&](Vertex vertex) {
+    Weight size = static_cast<Weight>(queue.size());
+    Weight average = queued_sum / size;
+    if constexpr (std::is_integral_v<Weight>) {
+      if (queued_sum % size != 0 && queued_sum < 0) {
+        --average;
+      }
+    }
+    return average < *dist[vertex];
+  };
+
+  while (!queue.empty()) {
+    // LLL: move labels above the queue average to the back
+    for (size_t moved = 0; moved < queue.size() && above_average(queue.front()); ++moved) {
+      queue.emplace_back(queue.front());
+      queue.pop_front();
+    }
+    Vertex vertex = queue.front();
+    queue.pop_front();
+    in_queue[vertex] = false;
+    queued_sum -= *dist[vertex];
+    if (on_cycle[vertex]) {
+      continue;
+    }
+    for (const auto& edge : adj_list_[vertex]) {
+      if (on_cycle[edge.dst]) {
+        continue;
+      }
+      Weight new_dist = *dist[vertex] + edge.weight;
+      if (dist[edge.dst].has_value() && !(new_dist < *dist[edge.dst])) {
+        continue;
+      }
+      if (in_queue[edge.dst]) {
+        queued_sum -= *dist[edge.dst];
+        queued_sum += new_dist;
+      }
+      dist[edge.dst] = new_dist;
+      depth[edge.dst] = depth[vertex] + 1;
+      if (depth[edge.dst] >= num_vertices) {
+        on_cycle[edge.dst] = true;
+        cycle_witnesses.emplace_back(edge.dst);
+        continue;
+      }
+      if (!in_queue[edge.dst]) {
+        in_queue[edge.dst] = true;
+        queued_sum += new_dist;
+        // SLF: labels smaller than the front go first
+        if (!queue.empty() && new_dist < *dist[queue.front()]) {
+          queue.emplace_front(edge.dst);
+        } else {
+          queue.emplace_back(edge.dst);
         }
       }
     }
   }
 
-  // // Detect negative vertices
-  // std::vector<Vertex> negative_vertices;
-  // for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
-  //   if (dist[vertex] == plus_inf) {
-  //     continue;
-  //   }
-  //   for (const auto& edge : adj_list_[vertex]) {
-  //     Weight new_dist = dist[vertex] + edge.weight;
-  //     if (dist[edge.dst] > new_dist) {
-  //       negative_vertices.emplace_back(edge.dst);
-  //     }
-  //   }
-  // }
-
-  // // Assign -inf
-  // std::vector<Vertex> stack;
-  // for (Vertex neg_start : negative_vertices) {
-  //   stack.emplace_back(neg_start);
-  //   dist[neg_start] = minus_inf;
-  //   while (!stack.empty()) {
-  //     Vertex vertex = stack.back();
-  //     stack.pop_back();
-  //     for (const auto& edge : adj_list_[vertex]) {
-  //       if (dist[edge.dst] != minus_inf) {
-  //         stack.emplace_back(edge.dst);
-  //         dist[edge.dst] = minus_inf;
-  //       }
-  //     }
-  //   }
-  // }
-  // return {negative_vertices.empty(), std::move(dist)};
-  return {true, std::move(dist)};
-}
-
-template <bool dir, class Wei>
+  // Constraints hold on every edge between unflagged vertices, so each
+  // negative cycle contains a flagged vertex or is reachable through one,
+  // and every flagged vertex is itself reachable from a negative cycle.
+  std::vector<bool> negative(num_vertices, false);
+  std::vector<Vertex> stack;
+  for (Vertex witness : cycle_witnesses) {
+    if (negative[witness]) {
+      continue;
+    }
+    negative[witness] = true;
+    stack.emplace_back(witness);
+    while (!stack.empty()) {
+      Vertex curr = stack.back();
+      stack.pop_back();
+      for (const auto& edge : adj_list_[curr]) {
+        if (!negative[edge.dst]) {
+          negative[edge.dst] = true;
+          stack.emplace_back(edge.dst);
+        }
+      }
+    }
+  }
+  std::vector<Vertex> negative_vertices;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (negative[vertex]) {
+      dist[vertex].reset();
+      negative_vertices.emplace_back(vertex);
+    }
+  }
+  return {std::move(dist), std::move(negative_vertices)};
+}
+
+// Blocked Floyd-Warshall. The matrix is padded to whole tiles of isolated
+// vertices; in every round the pivot tile is closed first, then its tile
+// row and column, then all remaining tiles, the last two phases in parallel.
+// Integer infinity is max() / 2 so that inf + inf does not overflow, which
+// requires path lengths to stay within +-max() / 4. Unreachable pairs are
+// returned as max(), a negative diagonal entry means a negative cycle.
+template <bool dir, class Wei, class Adj>
 template <class Weight, EnifWeighted<Wei, Weight>>
-std::optional<std::vector<std::vector<Weight>>> Graph<dir, Wei>::FloydWarshall() const {
+std::optional<Matrix<Weight>> Graph<dir, Wei, Adj>::FloydWarshall(size_t num_threads) const {
+  constexpr size_t block = 64ul;
+  constexpr bool is_float = std::numeric_limits<Weight>::has_infinity;
+  constexpr Weight inf =
+      is_float ? std::numeric_limits<Weight>::infinity() : std::numeric_limits<Weight>::max() / 2;
+  const size_t num_vertices = adj_list_.size();
+  const size_t num_blocks = (num_vertices + block - 1) / block;
+  const size_t stride = num_blocks * block;
+
+  std::vector<Weight> dist(stride * stride, inf);
+  for (Vertex vertex = 0; vertex < stride; ++vertex) {
+    dist[vertex * stride + vertex] = 0;
+  }
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (const auto& edge : adj_list_[vertex]) {
+      Weight& cell = dist[vertex * stride + edge.dst];
+      cell = std::min<Weight>(cell, edge.weight);
+    }
+  }
+
+  auto tile = [&](size_t row, size_t col) { return dist.data() + (row * stride + col) * block; };
+  auto has_negative_cycle = [&] {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (dist[vertex * stride + vertex] < 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  detail::ThreadPool pool(std::min(num_threads, num_blocks * num_blocks));
+  for (size_t pivot = 0; pivot < num_blocks; ++pivot) {
+    Weight* pivot_tile = tile(pivot, pivot);
+    detail::MinPlusTile(pivot_tile, pivot_tile, pivot_tile, stride, block, inf);
+    pool.Run(
+        2 * num_blocks,
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t index = begin; index < end; ++index) {
+            size_t other = index / 2;
+            if (other == pivot) {
+              continue;
+            }
+            if (index % 2 == 0) {
+              Weight* row_tile = tile(pivot, other);
+              detail::MinPlusTile(row_tile, pivot_tile, row_tile, stride, block, inf);
+            } else {
+              Weight* col_tile = tile(other, pivot);
+              detail::MinPlusTile(col_tile, col_tile, pivot_tile, stride, block, inf);
+            }
+          }
+        },
+        1ul);
+    pool.Run(
+        num_blocks * num_blocks,
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t index = begin; index < end; ++index) {
+            size_t row = index / num_blocks;
+            size_t col = index % num_blocks;
+            if (row != pivot && col != pivot) {
+              detail::MinPlusTile(tile(row, col), tile(row, pivot), tile(pivot, col), stride, block, inf);
+            }
+          }
+        },
+        1ul);
+    // Bail out early, negative cycles make the entries fall without bound
+    if (has_negative_cycle()) {
+      return {};
+    }
+  }
+
+  Matrix<Weight> answer(num_vertices, num_vertices);
+  for (Vertex src = 0; src < num_vertices; ++src) {
+    const Weight* row = dist.data() + src * stride;
+    Weight* answer_row = answer[src];
+    for (Vertex dst = 0; dst < num_vertices; ++dst) {
+      bool unreachable = is_float ? row[dst] == inf : row[dst] > inf / 2;
+      answer_row[dst] = unreachable ? std::numeric_limits<Weight>::max() : row[dst];
+    }
+  }
+  return answer;
 }
-template <bool dir, class Wei>
+
+template <bool dir, class Wei, class Adj>
 template <class Weight, EnifWeighted<Wei, Weight>>
-std::optional<std::vector<std::vector<std::optional<Weight>>>> Graph<dir, Wei>::Johnson() const {
-  auto [no_neg_cycle, potential] = BellmanFord(adj_list_.size());
-  if (!no_neg_cycle) {
+std::optional<std::vector<std::vector<std::optional<Weight>>>> Graph<dir, Wei, Adj>::Johnson() const {
+  auto [potential, negative_vertices] = SPFA(adj_list_.size());
+  if (!negative_vertices.empty()) {
     return {};
   }
   Graph<dir, Wei> new_g(adj_list_.size());
   for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
     for (const auto& edge : adj_list_[vertex]) {
       if constexpr (dir) {
-        new_g.AddEdge(vertex, edge.dst, edge.weight + potential[edge.dst] - potential[vertex]);
+        new_g.AddEdge(vertex, edge.dst, edge.weight + *potential[vertex] - *potential[edge.dst]);
       } else {
         if (vertex < edge.dst) {
-          new_g.AddEdge(vertex, edge.dst, edge.weight + potential[edge.dst] - potential[vertex]);
+          new_g.AddEdge(vertex, edge.dst, edge.weight + *potential[vertex] - *potential[edge.dst]);
         }
       }
     }
@@ -174,8 +644,164 @@ std::optional<std::vector<std::vector<std::optional<Weight>>>> Graph<dir, Wei>::
   std::vector<std::vector<std::optional<Weight>>> answer;
   for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
     answer.emplace_back(new_g.Dijkstra(vertex));
+    for (Vertex dst = 0; dst < adj_list_.size(); ++dst) {
+      if (answer.back()[dst].has_value()) {
+        *answer.back()[dst] += *potential[dst] - *potential[vertex];
+      }
+    }
+  }
+  return answer;
+}
+
+// Dijkstra into a caller-owned row prefilled with max(). A vertex is
+// settled when settled[v] == start + 1, so the buffers need no reset
+// between sources, and the queue is always drained on return.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+void Graph<dir, Wei, Adj>::DijkstraRow(Vertex start, Weight* row, Queue<Weight>& queue,
+                                       std::vector<size_t>& settled) const {
+  const size_t stamp = start + 1;
+  row[start] = 0;
+  queue.Push(start, 0);
+  while (!queue.Empty()) {
+    auto [weight, vertex] = queue.ExtractMin();
+    if (settled[vertex] == stamp) {
+      continue;
+    }
+    settled[vertex] = stamp;
+    for (const auto& edge : adj_list_[vertex]) {
+      if (settled[edge.dst] == stamp) {
+        continue;
+      }
+      Weight new_weight = weight + edge.weight;
+      if (new_weight < row[edge.dst]) {
+        row[edge.dst] = new_weight;
+        queue.Push(edge.dst, new_weight);
+      }
+    }
   }
+}
+
+// All-pairs Johnson into one N x N matrix; unreachable pairs hold
+// std::numeric_limits<Weight>::max(). Sources are spread over threads,
+// each reusing its own queue and settled stamps for all its rows.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, class Weight, EnifWeighted<Wei, Weight>>
+std::optional<Matrix<Weight>> Graph<dir, Wei, Adj>::JohnsonMatrix(size_t num_threads) const {
+  constexpr Weight plus_inf = std::numeric_limits<Weight>::max();
+  const size_t num_vertices = adj_list_.size();
+  auto [potential, negative_vertices] = SPFA(num_vertices);
+  if (!negative_vertices.empty()) {
+    return {};
+  }
+
+  // Reduced weights are non-negative, every arc is kept as a directed one
+  std::vector<Edge<Weight>> arcs;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (const auto& edge : adj_list_[vertex]) {
+      arcs.emplace_back(vertex, edge.dst, edge.weight + *potential[vertex] - *potential[edge.dst]);
+    }
+  }
+  Graph<true, Wei, CSRAdjacency<Wei>> reduced(num_vertices, arcs);
+
+  Matrix<Weight> answer(num_vertices, num_vertices, plus_inf);
+  num_threads = std::max(num_threads, 1ul);
+  std::vector<std::optional<Queue<Weight>>> queues(num_threads);
+  std::vector<std::vector<size_t>> settled(num_threads);
+  detail::ParallelFor(
+      num_vertices, num_threads,
+      [&](size_t thread_id, size_t begin, size_t end) {
+        if (!queues[thread_id].has_value()) {
+          queues[thread_id].emplace(num_vertices);
+          settled[thread_id].assign(num_vertices, 0ul);
+        }
+        for (Vertex source = begin; source < end; ++source) {
+          Weight* row = answer[source];
+          reduced.DijkstraRow(source, row, *queues[thread_id], settled[thread_id]);
+          for (Vertex dst = 0; dst < num_vertices; ++dst) {
+            if (row[dst] != plus_inf) {
+              row[dst] += *potential[dst] - *potential[source];
+            }
+          }
+        }
+      },
+      1ul);
   return answer;
 }
 
+// Single-source paths on a DAG by relaxing arcs in topological order, in
+// O(V + E) and with any sign of weights. Compare picks the better of two
+// lengths: std::less for shortest paths, std::greater for longest.
+// Returns {} if the graph has a cycle.
+template <bool dir, class Wei, class Adj>
+template <class Weight, class Compare>
+std::optional<std::vector<std::optional<Weight>>> Graph<dir, Wei, Adj>::DAGPaths(Vertex start,
+                                                                                 Compare better) const {
+  auto [acyclic, order] = TopSort();
+  if (!acyclic) {
+    return {};
+  }
+  std::vector<std::optional<Weight>> dist(adj_list_.size());
+  dist[start] = 0;
+  for (Vertex vertex : order) {
+    if (!dist[vertex].has_value()) {
+      continue;
+    }
+    for (const auto& edge : adj_list_[vertex]) {
+      Weight candidate = *dist[vertex] + edge.weight;
+      if (!dist[edge.dst].has_value() || better(candidate, *dist[edge.dst])) {
+        dist[edge.dst] = candidate;
+      }
+    }
+  }
+  return dist;
+}
+
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifDirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::optional<std::vector<std::optional<Weight>>> Graph<dir, Wei, Adj>::DAGShortestPaths(Vertex start) const {
+  return DAGPaths<Weight>(start, std::less<Weight>{});
+}
+
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifDirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::optional<std::vector<std::optional<Weight>>> Graph<dir, Wei, Adj>::DAGLongestPaths(Vertex start) const {
+  return DAGPaths<Weight>(start, std::greater<Weight>{});
+}
+
+// Heaviest path of the whole DAG, starting anywhere (an empty path of a
+// single vertex has length 0). num_settled is the number of vertices.
+// Returns {} if the graph has a cycle or no vertices.
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifDirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::optional<Path<Weight>> Graph<dir, Wei, Adj>::CriticalPath() const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
+  const size_t num_vertices = adj_list_.size();
+  auto [acyclic, order] = TopSort();
+  if (!acyclic || num_vertices == 0) {
+    return {};
+  }
+  std::vector<Weight> dist(num_vertices, 0);
+  std::vector<Vertex> parent(num_vertices, kNone);
+  Vertex last = order.front();
+  for (Vertex vertex : order) {
+    if (dist[vertex] > dist[last]) {
+      last = vertex;
+    }
+    for (const auto& edge : adj_list_[vertex]) {
+      Weight candidate = dist[vertex] + edge.weight;
+      if (candidate > dist[edge.dst]) {
+        dist[edge.dst] = candidate;
+        parent[edge.dst] = vertex;
+      }
+    }
+  }
+  Path<Weight> path{dist[last], {}, num_vertices};
+  for (Vertex vertex = last; vertex != kNone; vertex = parent[vertex]) {
+    path.vertices.emplace_back(vertex);
+  }
+  std::reverse(path.vertices.begin(), path.vertices.end());
+  return path;
+}
+
 #endif
@@ -1,20 +1,31 @@
 #ifndef GRAPH_EULER_H_
 #define GRAPH_EULER_H_
 
+#include <algorithm>
 #include "./_graph_class.h"
+#include "../other/disjoint_set_union.h"
 
-template <bool dir, class Wei>
-std::optional<std::pair<Vertex, Vertex>> Graph<dir, Wei>::CheckIfSemiEuler() const {
+// Returns the endpoints {start, end} of an Euler path, start == end when
+// there is an Euler cycle. Degrees are checked first, then one DSU pass
+// over the arcs checks that all non-isolated vertices are connected
+// (weak connectivity suffices once the degrees are balanced). A graph
+// without vertices has no vertex to start from and yields nothing.
+template <bool dir, class Wei, class Adj>
+std::optional<std::pair<Vertex, Vertex>> Graph<dir, Wei, Adj>::CheckIfSemiEuler() const {
+  const size_t num_vertices = adj_list_.size();
+  if (num_vertices == 0) {
+    return {};
+  }
   std::optional<Vertex> start{};
   std::optional<Vertex> end{};
   if constexpr (dir) {
-    std::vector<size_t> num_in(adj_list_.size(), 0ul);
-    for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+    std::vector<size_t> num_in(num_vertices, 0ul);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
       for (const auto& edge : adj_list_[vertex]) {
         ++num_in[edge.dst];
       }
     }
-    for (Vertex vertex = 0; vertex < adj_list_.size(); ++vertex) {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
       if (num_in[vertex] == adj_list_[vertex].size()) {
         continue;
       } else if (num_in[vertex] == adj_list_[vertex].size() + 1) {
@@ -34,33 +45,110 @@ std::optional<std::pair<Vertex, Vertex>> Graph<dir, Wei>::CheckIfSemiEuler() con
     if (start.has_value() ^ end.has_value()) {
       return {};
     }
-    if (SCC().size() > 1) {
-      return {};
+  } else {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (adj_list_[vertex].size() % 2 == 0) {
+        continue;
+      }
+      if (!start.has_value()) {
+        start = vertex;
+      } else if (!end.has_value()) {
+        end = vertex;
+      } else {
+        return {};
+      }
     }
-    if (start.has_value()) {
-      return {{*start, *end}};
+  }
+
+  DSU components(num_vertices);
+  std::optional<Vertex> any_arc_vertex{};
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (const auto& edge : adj_list_[vertex]) {
+      components.Union(vertex, edge.dst);
     }
+    if (!any_arc_vertex.has_value() && !adj_list_[vertex].empty()) {
+      any_arc_vertex = vertex;
+    }
+  }
+  if (!any_arc_vertex.has_value()) {
     return {{0, 0}};
   }
-  // TODO
+  size_t root = components.FindSet(*any_arc_vertex);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (!adj_list_[vertex].empty() && components.FindSet(vertex) != root) {
+      return {};
+    }
+  }
+  if (start.has_value()) {
+    return {{*start, *end}};
+  }
+  return {{*any_arc_vertex, *any_arc_vertex}};
 }
 
-template <bool dir, class Wei>
-bool Graph<dir, Wei>::CheckIfEuler() const {
-  // TODO
-  return false;
+template <bool dir, class Wei, class Adj>
+bool Graph<dir, Wei, Adj>::CheckIfEuler() const {
+  auto ends = CheckIfSemiEuler();
+  return ends.has_value() && ends->first == ends->second;
 }
 
-template <bool dir, class Wei>
-std::vector<Vertex> Graph<dir, Wei>::EulerPath() const {
-  // TODO
-  return {};
+// Vertices of an Euler path (edges + 1 of them), empty if there is none
+template <bool dir, class Wei, class Adj>
+std::vector<Vertex> Graph<dir, Wei, Adj>::EulerPath() const {
+  auto ends = CheckIfSemiEuler();
+  if (!ends.has_value()) {
+    return {};
+  }
+  return Hierholzer(ends->first);
+}
+
+// Closed walk, front() == back(), empty if there is no Euler cycle
+template <bool dir, class Wei, class Adj>
+std::vector<Vertex> Graph<dir, Wei, Adj>::EulerCycle() const {
+  auto ends = CheckIfSemiEuler();
+  if (!ends.has_value() || ends->first != ends->second) {
+    return {};
+  }
+  return Hierholzer(ends->first);
 }
 
-template <bool dir, class Wei>
-std::vector<Vertex> Graph<dir, Wei>::EulerCycle() const {
-  // TODO
-  return {};
+// Iterative Hierholzer over flat arcs with a cursor per vertex, O(V + E).
+// In undirected graphs both copies of an edge share a used flag.
+template <bool dir, class Wei, class Adj>
+std::vector<Vertex> Graph<dir, Wei, Adj>::Hierholzer(Vertex start) const {
+  std::vector<size_t> offsets = ArcOffsets();
+  std::vector<Vertex> head = ArcHeads();
+  const size_t num_arcs = head.size();
+  std::vector<size_t> twin;
+  std::vector<bool> used;
+  if constexpr (!dir) {
+    twin = ArcTwins(offsets, head);
+    used.assign(num_arcs, false);
+  }
+
+  std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+  std::vector<Vertex> stack{start};
+  std::vector<Vertex> path;
+  path.reserve((dir ? num_arcs : num_arcs / 2) + 1);
+  while (!stack.empty()) {
+    Vertex vertex = stack.back();
+    size_t& arc = cursor[vertex];
+    if constexpr (!dir) {
+      while (arc < offsets[vertex + 1] && used[arc]) {
+        ++arc;
+      }
+    }
+    if (arc == offsets[vertex + 1]) {
+      path.emplace_back(vertex);
+      stack.pop_back();
+      continue;
+    }
+    if constexpr (!dir) {
+      used[arc] = used[twin[arc]] = true;
+    }
+    stack.emplace_back(head[arc++]);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,16 +3,487 @@
 
 #include <unordered_map>
 #include <vector>
-#include <deque>
 #include <algorithm>
 #include <utility>
 #include <limits>
-#include <functional>
+#include <type_traits>
 #include "./_graph_class.h"
+#include "./_graph_residual.h"
+#include "./graph_distance.h"
 
-template <bool dir, class Wei>
+namespace detail {
+
+// Highest-label push-relabel (first phase only: computes a maximum
+// preflow, whose value equals the maximum flow). Vertices of every label
+// below n are kept in doubly linked lists for the gap heuristic, active
+// ones additionally in per-label stacks. Exact labels are recomputed by a
+// backward BFS from the sink after O(n + m) relabeling work.
+template <class Cap>
+class PushRelabel {
+  static constexpr Vertex kNone = static_cast<Vertex>(-1);
+
+  ResidualNetwork<Cap>& net_;
+  size_t n_;
+  Vertex source_;
+  Vertex sink_;
+  std::vector<size_t> height_;
+  std::vector<Cap> excess_;
+  std::vector<size_t> current_;
+  std::vector<Vertex> bucket_head_;
+  std::vector<Vertex> bucket_next_;
+  std::vector<Vertex> bucket_prev_;
+  std::vector<Vertex> active_head_;
+  std::vector<Vertex> active_next_;
+  size_t max_height_{0ul};
+  size_t max_active_{0ul};
+  size_t work_{0ul};
+
+ public:
+  explicit PushRelabel(ResidualNetwork<Cap>&);
+  Cap Run(Vertex, Vertex);
+  // Vertices that cannot reach the sink in the residual network
+  std::vector<bool> SourceSide() const;
+
+ private:
+  void GlobalRelabel();
+  void Discharge(Vertex);
+  void Gap(size_t);
+  void Activate(Vertex);
+  void Insert(Vertex);
+  void Remove(Vertex);
+};
+
+template <class Cap>
+PushRelabel<Cap>::PushRelabel(ResidualNetwork<Cap>& net)
+    : net_{net},
+      n_{net.NumVertices()},
+      source_{0},
+      sink_{0},
+      height_(n_),
+      excess_(n_),
+      current_(n_),
+      bucket_head_(n_ + 1),
+      bucket_next_(n_),
+      bucket_prev_(n_),
+      active_head_(n_ + 1),
+      active_next_(n_) {
+}
+
+template <class Cap>
+Cap PushRelabel<Cap>::Run(Vertex source, Vertex sink) {
+  source_ = source;
+  sink_ = sink;
+  if (source == sink) {
+    return Cap{};
+  }
+  std::fill(excess_.begin(), excess_.end(), Cap{});
+  for (size_t arc = net_.offsets[source]; arc < net_.offsets[source + 1]; ++arc) {
+    Cap delta = net_.residual[arc];
+    if (delta > Cap{}) {
+      net_.Push(arc, delta);
+      excess_[net_.head[arc]] += delta;
+    }
+  }
+  GlobalRelabel();
+  const size_t relabel_period = 6 * n_ + net_.NumArcs() / 2;
+  while (true) {
+    while (max_active_ > 0 && active_head_[max_active_] == kNone) {
+      --max_active_;
+    }
+    Vertex vertex = active_head_[max_active_];
+    if (vertex == kNone) {
+      break;
+    }
+    active_head_[max_active_] = active_next_[vertex];
+    Discharge(vertex);
+    if (work_ > relabel_period) {
+      GlobalRelabel();
+    }
+  }
+  return excess_[sink];
+}
+
+template <class Cap>
+void PushRelabel<Cap>::GlobalRelabel() {
+  std::fill(height_.begin(), height_.end(), n_);
+  std::fill(bucket_head_.begin(), bucket_head_.end(), kNone);
+  std::fill(active_head_.begin(), active_head_.end(), kNone);
+  max_height_ = max_active_ = work_ = 0ul;
+  height_[sink_] = 0;
+  std::vector<Vertex> order{sink_};
+  for (size_t index = 0; index < order.size(); ++index) {
+    Vertex vertex = order[index];
+    for (size_t arc = net_.offsets[vertex]; arc < net_.offsets[vertex + 1]; ++arc) {
+      Vertex neigh = net_.head[arc];
+      if (height_[neigh] == n_ && neigh != source_ && net_.residual[net_.reverse[arc]] > Cap{}) {
+        height_[neigh] = height_[vertex] + 1;
+        order.emplace_back(neigh);
+      }
+    }
+  }
+  for (size_t index = 1; index < order.size(); ++index) {
+    Vertex vertex = order[index];
+    current_[vertex] = net_.offsets[vertex];
+    Insert(vertex);
+    if (excess_[vertex] > Cap{}) {
+      Activate(vertex);
+    }
+  }
+}
+
+template <class Cap>
+void PushRelabel<Cap>::Discharge(Vertex vertex) {
+  while (true) {
+    size_t height = height_[vertex];
+    size_t& arc = current_[vertex];
+    for (size_t end = net_.offsets[vertex + 1]; arc < end; ++arc) {
+      Vertex neigh = net_.head[arc];
+      if (net_.residual[arc] > Cap{} && height_[neigh] + 1 == height) {
+        Cap delta = std::min(excess_[vertex], net_.residual[arc]);
+        net_.Push(arc, delta);
+        if (neigh != sink_ && excess_[neigh] == Cap{}) {
+          Activate(neigh);
+        }
+        excess_[neigh] += delta;
+        excess_[vertex] -= delta;
+        if (excess_[vertex] == Cap{}) {
+          return;
+        }
+      }
+    }
+
+    // Relabel
+    Remove(vertex);
+    if (bucket_head_[height] == kNone) {
+      height_[vertex] = n_;
+      Gap(height);
+      return;
+    }
+    size_t new_height = n_;
+    for (size_t arc = net_.offsets[vertex]; arc < net_.offsets[vertex + 1]; ++arc) {
+      if (net_.residual[arc] > Cap{}) {
+        new_height = std::min(new_height, height_[net_.head[arc]] + 1);
+      }
+    }
+    work_ += net_.offsets[vertex + 1] - net_.offsets[vertex] + 12;
+    height_[vertex] = new_height;
+    if (new_height >= n_) {
+      return;
+    }
+    current_[vertex] = net_.offsets[vertex];
+    Insert(vertex);
+  }
+}
+
+// No vertex is left with label `height`: everything above it can no
+// longer reach the sink and is dropped from the first phase.
+template <class Cap>
+void PushRelabel<Cap>::Gap(size_t height) {
+  for (size_t label = height + 1; label <= max_height_; ++label) {
+    for (Vertex vertex = bucket_head_[label]; vertex != kNone; vertex = bucket_next_[vertex]) {
+      height_[vertex] = n_;
+    }
+    bucket_head_[label] = kNone;
+    active_head_[label] = kNone;
+  }
+  max_height_ = height - 1;
+  max_active_ = std::min(max_active_, max_height_);
+}
+
+template <class Cap>
+void PushRelabel<Cap>::Activate(Vertex vertex) {
+  size_t height = height_[vertex];
+  active_next_[vertex] = active_head_[height];
+  active_head_[height] = vertex;
+  max_active_ = std::max(max_active_, height);
+}
+
+template <class Cap>
+void PushRelabel<Cap>::Insert(Vertex vertex) {
+  size_t height = height_[vertex];
+  bucket_prev_[vertex] = kNone;
+  bucket_next_[vertex] = bucket_head_[height];
+  if (bucket_head_[height] != kNone) {
+    bucket_prev_[bucket_head_[height]] = vertex;
+  }
+  bucket_head_[height] = vertex;
+  max_height_ = std::max(max_height_, height);
+}
+
+template <class Cap>
+void PushRelabel<Cap>::Remove(Vertex vertex) {
+  size_t height = height_[vertex];
+  if (bucket_prev_[vertex] != kNone) {
+    bucket_next_[bucket_prev_[vertex]] = bucket_next_[vertex];
+  } else {
+    bucket_head_[height] = bucket_next_[vertex];
+  }
+  if (bucket_next_[vertex] != kNone) {
+    bucket_prev_[bucket_next_[vertex]] = bucket_prev_[vertex];
+  }
+}
+
+template <class Cap>
+std::vector<bool> PushRelabel<Cap>::SourceSide() const {
+  std::vector<bool> source_side(n_, true);
+  source_side[sink_] = false;
+  std::vector<Vertex> order{sink_};
+  for (size_t index = 0; index < order.size(); ++index) {
+    Vertex vertex = order[index];
+    for (size_t arc = net_.offsets[vertex]; arc < net_.offsets[vertex + 1]; ++arc) {
+      Vertex neigh = net_.head[arc];
+      if (source_side[neigh] && net_.residual[net_.reverse[arc]] > Cap{}) {
+        source_side[neigh] = false;
+        order.emplace_back(neigh);
+      }
+    }
+  }
+  return source_side;
+}
+
+// Dinic over the flat residual network. Blocking flows are found with
+// per-vertex current-arc pointers and an explicit stack of path arcs, so
+// every arc is advanced past at most once per phase. A positive delta
+// restricts the search to arcs with at least delta residual capacity,
+// zero means any positive residual capacity.
+template <class Cap>
+class Dinic {
+  static constexpr size_t kUnreached = static_cast<size_t>(-1);
+
+  ResidualNetwork<Cap>& net_;
+  std::vector<size_t> level_;
+  std::vector<size_t> current_;
+  std::vector<Vertex> queue_;
+  std::vector<size_t> path_;
+
+ public:
+  explicit Dinic(ResidualNetwork<Cap>&);
+  // Augments on top of the flow already in the network
+  Cap Run(Vertex, Vertex);
+  Cap RunScaling(Vertex, Vertex);
+
+ private:
+  Cap Phases(Vertex, Vertex, Cap delta);
+  bool BuildLevels(Vertex, Vertex, Cap delta);
+  Cap BlockingFlow(Vertex, Vertex, Cap delta);
+  bool Usable(size_t arc, Cap delta) const {
+    return delta > Cap{} ? net_.residual[arc] >= delta : net_.residual[arc] > Cap{};
+  }
+};
+
+template <class Cap>
+Dinic<Cap>::Dinic(ResidualNetwork<Cap>& net)
+    : net_{net}, level_(net.NumVertices()), current_(net.NumVertices()) {
+  queue_.reserve(net.NumVertices());
+}
+
+template <class Cap>
+Cap Dinic<Cap>::Run(Vertex source, Vertex sink) {
+  return Phases(source, sink, Cap{});
+}
+
+template <class Cap>
+Cap Dinic<Cap>::RunScaling(Vertex source, Vertex sink) {
+  Cap max_capacity{};
+  for (Cap residual : net_.residual) {
+    max_capacity = std::max(max_capacity, residual);
+  }
+  Cap delta = 1;
+  while (delta <= max_capacity / 2) {
+    delta *= 2;
+  }
+  Cap flow{};
+  for (; delta > Cap{}; delta /= 2) {
+    flow += Phases(source, sink, delta);
+  }
+  return flow;
+}
+
+template <class Cap>
+Cap Dinic<Cap>::Phases(Vertex source, Vertex sink, Cap delta) {
+  Cap flow{};
+  if (source == sink) {
+    return flow;
+  }
+  while (BuildLevels(source, sink, delta)) {
+    flow += BlockingFlow(source, sink, delta);
+  }
+  return flow;
+}
+
+template <class Cap>
+bool Dinic<Cap>::BuildLevels(Vertex source, Vertex sink, Cap delta) {
+  std::fill(level_.begin(), level_.end(), kUnreached);
+  level_[source] = 0;
+  queue_.assign(1, source);
+  for (size_t index = 0; index < queue_.size(); ++index) {
+    Vertex vertex = queue_[index];
+    // Nothing beyond the sink's layer lies on a shortest path
+    if (level_[sink] != kUnreached && level_[vertex] >= level_[sink]) {
+      break;
+    }
+    for (size_t arc = net_.offsets[vertex]; arc < net_.offsets[vertex + 1]; ++arc) {
+      Vertex neigh = net_.head[arc];
+      if (level_[neigh] == kUnreached && Usable(arc, delta)) {
+        level_[neigh] = level_[vertex] + 1;
+        queue_.emplace_back(neigh);
+      }
+    }
+  }
+  std::copy(net_.offsets.begin(), net_.offsets.end() - 1, current_.begin());
+  return level_[sink] != kUnreached;
+}
+
+template <class Cap>
+Cap Dinic<Cap>::BlockingFlow(Vertex source, Vertex sink, Cap delta) {
+  Cap flow{};
+  Vertex vertex = source;
+  path_.clear();
+  while (true) {
+    if (vertex == sink) {
+      Cap bottleneck = net_.residual[path_.front()];
+      for (size_t arc : path_) {
+        bottleneck = std::min(bottleneck, net_.residual[arc]);
+      }
+      // Retreat to the tail of the first arc that became unusable
+      size_t keep = path_.size();
+      for (size_t index = 0; index < path_.size(); ++index) {
+        net_.Push(path_[index], bottleneck);
+        if (keep == path_.size() && !Usable(path_[index], delta)) {
+          keep = index;
+        }
+      }
+      flow += bottleneck;
+      path_.resize(keep);
+      vertex = path_.empty() ? source : net_.head[path_.back()];
+      continue;
+    }
+
+    size_t& arc = current_[vertex];
+    size_t end = net_.offsets[vertex + 1];
+    while (arc < end && !(level_[net_.head[arc]] == level_[vertex] + 1 && Usable(arc, delta))) {
+      ++arc;
+    }
+    if (arc < end) {
+      path_.emplace_back(arc);
+      vertex = net_.head[arc];
+      continue;
+    }
+
+    // Dead end: no augmenting path goes through vertex in this phase
+    level_[vertex] = kUnreached;
+    if (path_.empty()) {
+      return flow;
+    }
+    vertex = net_.head[net_.reverse[path_.back()]];
+    path_.pop_back();
+    ++current_[vertex];
+  }
+}
+
+// Arc costs for a network built from CapacityCost weights, reverse arcs
+// cost the negated amount
+template <class Price, class Adj, class Cap>
+std::vector<Price> ArcCosts(const Adj& adj, const ResidualNetwork<Cap>& net) {
+  std::vector<Price> cost(net.NumArcs());
+  size_t index = 0;
+  for (Vertex vertex = 0; vertex < adj.size(); ++vertex) {
+    for (const auto& edge : adj[vertex]) {
+      size_t arc = net.forward[index++];
+      cost[arc] = edge.weight.cost;
+      cost[net.reverse[arc]] = -cost[arc];
+    }
+  }
+  return cost;
+}
+
+// Goldberg-Tarjan cost scaling: turns the flow already in `net` into a
+// minimum-cost one with the same vertex balances. Integral costs are
+// multiplied by n + 1, so the final 1-optimal flow is optimal. Every
+// refine saturates the arcs of negative reduced cost and then restores
+// the balances by FIFO push/relabel on admissible arcs.
+template <class Cap, class Price>
+void CostScaling(ResidualNetwork<Cap>& net, const std::vector<Price>& cost) {
+  constexpr Price kAlpha = 8;
+  const size_t num_vertices = net.NumVertices();
+  std::vector<Price> scaled(cost.size());
+  Price epsilon = 0;
+  for (size_t arc = 0; arc < cost.size(); ++arc) {
+    scaled[arc] = cost[arc] * static_cast<Price>(num_vertices + 1);
+    epsilon = std::max(epsilon, scaled[arc]);
+  }
+  std::vector<Price> price(num_vertices, 0);
+  std::vector<Cap> excess(num_vertices);
+  std::vector<size_t> current(num_vertices);
+  std::vector<bool> queued(num_vertices, false);
+  std::vector<Vertex> queue;
+  auto reduced = [&](Vertex vertex, size_t arc) { return scaled[arc] + price[vertex] - price[net.head[arc]]; };
+
+  while (epsilon > 1) {
+    epsilon = std::max<Price>(epsilon / kAlpha, 1);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      for (size_t arc = net.offsets[vertex]; arc < net.offsets[vertex + 1]; ++arc) {
+        if (net.residual[arc] > Cap{} && reduced(vertex, arc) < 0) {
+          excess[vertex] -= net.residual[arc];
+          excess[net.head[arc]] += net.residual[arc];
+          net.Push(arc, net.residual[arc]);
+        }
+      }
+    }
+    queue.clear();
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      current[vertex] = net.offsets[vertex];
+      if (excess[vertex] > Cap{}) {
+        queue.emplace_back(vertex);
+        queued[vertex] = true;
+      }
+    }
+    for (size_t index = 0; index < queue.size(); ++index) {
+      Vertex vertex = queue[index];
+      queued[vertex] = false;
+      while (excess[vertex] > Cap{}) {
+        size_t& arc = current[vertex];
+        if (arc == net.offsets[vertex + 1]) {
+          // Relabel: the cheapest residual arc gets reduced cost -epsilon
+          bool found = false;
+          Price new_price = 0;
+          for (size_t other = net.offsets[vertex]; other < net.offsets[vertex + 1]; ++other) {
+            if (net.residual[other] > Cap{}) {
+              Price candidate = price[net.head[other]] - scaled[other];
+              new_price = found ? std::max(new_price, candidate) : candidate;
+              found = true;
+            }
+          }
+          if (!found) {
+            break;
+          }
+          price[vertex] = new_price - epsilon;
+          arc = net.offsets[vertex];
+          continue;
+        }
+        Vertex neigh = net.head[arc];
+        if (net.residual[arc] > Cap{} && reduced(vertex, arc) < 0) {
+          Cap delta = std::min(excess[vertex], net.residual[arc]);
+          net.Push(arc, delta);
+          excess[vertex] -= delta;
+          excess[neigh] += delta;
+          if (excess[neigh] > Cap{} && !queued[neigh]) {
+            queue.emplace_back(neigh);
+            queued[neigh] = true;
+          }
+        } else {
+          ++arc;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+template <bool dir, class Wei, class Adj>
 template <bool directed, class Weight, EnifWeighted<Wei, Weight>>
-Weight Graph<dir, Wei>::FordFulkerson(Vertex source, Vertex destination) const {
+Weight Graph<dir, Wei, Adj>::FordFulkerson(Vertex source, Vertex destination) const {
   std::vector<std::unordered_map<Vertex, std::pair<Weight, Weight>>> transport_net(adj_list_.size());
   for (Vertex u = 0; u < adj_list_.size(); ++u) {
     for (const auto& edge : adj_list_[u]) {
@@ -45,10 +516,10 @@ Weight Graph<dir, Wei>::FordFulkerson(Vertex source, Vertex destination) const {
   return answer;
 }
 
-template <bool dir, class Weight>
-bool Graph<dir, Weight>::RecursiveDFSFordFulkerson(
+template <bool dir, class Wei, class Adj>
+bool Graph<dir, Wei, Adj>::RecursiveDFSFordFulkerson(
     Vertex vertex, Vertex destination,
-    std::vector<std::unordered_map<Vertex, std::pair<Weight, Weight>>>& transport_net, std::vector<Vertex>& path,
+    std::vector<std::unordered_map<Vertex, std::pair<Wei, Wei>>>& transport_net, std::vector<Vertex>& path,
     std::vector<bool>& visited) const {
   visited[vertex] = true;
   path.emplace_back(vertex);
@@ -67,97 +538,148 @@ bool Graph<dir, Weight>::RecursiveDFSFordFulkerson(
   return false;
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <bool directed, class Weight, EnifWeighted<Wei, Weight>>
-Weight Graph<dir, Wei>::EdmondsKarp(Vertex, Vertex) const {
+Weight Graph<dir, Wei, Adj>::EdmondsKarp(Vertex, Vertex) const {
 }
 
-template <bool dir, class Wei>
+// Capacity scaling is opt-in: with capacity_scaling = true (integral
+// capacities only) Dinic runs once per power of two delta, looking only at
+// arcs with at least delta residual capacity, which bounds the number of
+// phases by O(E log U). Non-integral weights ignore the flag.
+template <bool dir, class Wei, class Adj>
 template <bool directed, class Weight, EnifWeighted<Wei, Weight>>
-Weight Graph<dir, Wei>::Dinic(Vertex source, Vertex destination) const {
-  struct FlowEdge {
-    Weight flow;
-    Weight capacity;
-    bool in_layer;
-  };
-  std::vector<std::unordered_map<Vertex, FlowEdge>> transport_net(adj_list_.size());
-  for (Vertex u = 0; u < adj_list_.size(); ++u) {
-    for (const auto& edge : adj_list_[u]) {
-      transport_net[u][edge.dst] = {0, edge.weight, false};
-      if (transport_net[edge.dst].find(u) == transport_net[edge.dst].end()) {
-        transport_net[edge.dst][u] = {0, 0, false};
+Weight Graph<dir, Wei, Adj>::Dinic(Vertex source, Vertex destination, bool capacity_scaling) const {
+  detail::ResidualNetwork<Weight> net(adj_list_, [](const auto& edge) { return edge.weight; });
+  detail::Dinic<Weight> solver(net);
+  if constexpr (std::is_integral_v<Weight>) {
+    if (capacity_scaling) {
+      return solver.RunScaling(source, destination);
+    }
+  }
+  return solver.Run(source, destination);
+}
+
+// Maximum flow value together with the source side of a minimum cut
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifWeighted<Wei, Weight>>
+std::pair<Weight, std::vector<bool>> Graph<dir, Wei, Adj>::PushRelabel(Vertex source, Vertex destination) const {
+  detail::ResidualNetwork<Weight> net(adj_list_, [](const auto& edge) { return edge.weight; });
+  detail::PushRelabel<Weight> solver(net);
+  Weight flow = solver.Run(source, destination);
+  return {flow, solver.SourceSide()};
+}
+
+// Successive shortest paths. Initial potentials come from SPFA over the
+// arcs with positive capacity, like in Johnson(); afterwards Dijkstra runs
+// on non-negative reduced costs and the distances are added to the
+// potentials. Returns {} if there is a negative-cost cycle.
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::optional<std::pair<typename Weight::CapacityType, typename Weight::CostType>>
+Graph<dir, Wei, Adj>::MinCostMaxFlow(Vertex source, Vertex destination) const {
+  using Cap = typename Weight::CapacityType;
+  using Cost = typename Weight::CostType;
+  const size_t num_vertices = adj_list_.size();
+  detail::ResidualNetwork<Cap> net(adj_list_, [](const auto& edge) { return edge.weight.capacity; });
+  std::vector<Cost> cost = detail::ArcCosts<Cost>(adj_list_, net);
+
+  std::vector<Cost> potential(num_vertices, Cost{});
+  std::vector<Edge<Cost>> arcs;
+  bool has_negative = false;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (size_t arc = net.offsets[vertex]; arc < net.offsets[vertex + 1]; ++arc) {
+      if (net.residual[arc] > Cap{}) {
+        arcs.emplace_back(vertex, net.head[arc], cost[arc]);
+        has_negative |= cost[arc] < Cost{};
       }
     }
   }
-  
-  std::vector<size_t> dist(adj_list_.size());
-  std::deque<Vertex> queue;
-  auto bfs = [destination, &transport_net, &dist, &queue](Vertex start) {
-    queue.emplace_back(start);
-    for (size_t i = 0; i < dist.size(); ++i) {
-      dist[i] = static_cast<size_t>(-1);
-    }
-    dist[start] = 0;
-    while (!queue.empty()) {
-      Vertex vertex = queue.front();
-      queue.pop_front();
-      for (auto& [neigh, fedge] : transport_net[vertex]) {
-        if (dist[neigh] <= dist[vertex] || fedge.flow == fedge.capacity) {
-          fedge.in_layer = false;
+  if (has_negative) {
+    // Start from every vertex at once, as from Johnson's virtual source
+    auto [dist, negative_vertices] = Graph<true, Cost, CSRAdjacency<Cost>>(num_vertices, arcs).SPFA(num_vertices);
+    if (!negative_vertices.empty()) {
+      return {};
+    }
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      potential[vertex] = *dist[vertex];
+    }
+  }
+
+  Cap flow{};
+  Cost total_cost{};
+  std::vector<Cost> dist(num_vertices);
+  std::vector<bool> reached(num_vertices);
+  std::vector<bool> settled(num_vertices);
+  std::vector<size_t> parent_arc(num_vertices);
+  QuaternaryHeap<Cost> queue(num_vertices);
+  while (source != destination) {
+    std::fill(reached.begin(), reached.end(), false);
+    std::fill(settled.begin(), settled.end(), false);
+    dist[source] = Cost{};
+    reached[source] = true;
+    queue.Push(source, Cost{});
+    while (!queue.Empty()) {
+      Vertex vertex = queue.ExtractMin().second;
+      settled[vertex] = true;
+      for (size_t arc = net.offsets[vertex]; arc < net.offsets[vertex + 1]; ++arc) {
+        Vertex neigh = net.head[arc];
+        if (net.residual[arc] == Cap{} || settled[neigh]) {
           continue;
         }
-        if (dist[neigh] == static_cast<size_t>(-1)) {
-          queue.emplace_back(neigh);
+        Cost candidate = dist[vertex] + cost[arc] + potential[vertex] - potential[neigh];
+        if (!reached[neigh] || candidate < dist[neigh]) {
+          reached[neigh] = true;
+          dist[neigh] = candidate;
+          parent_arc[neigh] = arc;
+          queue.Push(neigh, candidate);
         }
-        dist[neigh] = dist[vertex] + 1;
-        fedge.in_layer = true;
       }
     }
-    return dist[destination] < static_cast<size_t>(-1);
-  };
-  
-  std::vector<Vertex> path;
-  std::vector<bool> visited(adj_list_.size(), false);
-  std::function<bool(Vertex)> rec_dfs;
-  rec_dfs = [destination, &rec_dfs, &transport_net, &path, &visited](Vertex vertex) {
-    visited[vertex] = true;
-    path.emplace_back(vertex);
-    if (vertex == destination) {
-      return true;
-    }
-    for (const auto& [neigh, fedge] : transport_net[vertex]) {
-      if (!visited[neigh] && fedge.in_layer && fedge.flow < fedge.capacity) {
-        if (rec_dfs(neigh)) {
-          return true;
-        }
+    if (!reached[destination]) {
+      break;
+    }
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (reached[vertex]) {
+        potential[vertex] += dist[vertex];
       }
     }
-    path.pop_back();
-    return false;
-  };
 
-  Weight answer = 0;
-  while (bfs(source)) {
-    while (rec_dfs(source)) {
-      Weight min_capacity = std::numeric_limits<Weight>::max();
-      for (size_t i = 1; i < path.size(); ++i) {
-        const FlowEdge& fedge = transport_net[path[i - 1]][path[i]];
-        min_capacity = std::min(min_capacity, fedge.capacity - fedge.flow);
-      }
-      for (size_t i = 1; i < path.size(); ++i) {
-        Vertex src = path[i - 1];
-        Vertex dst = path[i];
-        transport_net[src][dst].flow += min_capacity;
-        transport_net[dst][src].flow -= min_capacity;
-      }
-      answer += min_capacity;
-      path.clear();
-      std::fill(visited.begin(), visited.end(), false);
+    Cap bottleneck = std::numeric_limits<Cap>::max();
+    for (Vertex vertex = destination; vertex != source; vertex = net.head[net.reverse[parent_arc[vertex]]]) {
+      bottleneck = std::min(bottleneck, net.residual[parent_arc[vertex]]);
     }
-    path.clear();
-    std::fill(visited.begin(), visited.end(), false);
+    for (Vertex vertex = destination; vertex != source; vertex = net.head[net.reverse[parent_arc[vertex]]]) {
+      net.Push(parent_arc[vertex], bottleneck);
+      total_cost += cost[parent_arc[vertex]] * bottleneck;
+    }
+    flow += bottleneck;
   }
-  return answer;
+  return std::make_pair(flow, total_cost);
+}
+
+// Maximum flow by Dinic, then cost scaling to the cheapest flow of that
+// value. Needs integral costs and signed capacities, and, unlike
+// MinCostMaxFlow, handles negative-cost cycles.
+template <bool dir, class Wei, class Adj>
+template <class Weight, EnifWeighted<Wei, Weight>>
+std::pair<typename Weight::CapacityType, typename Weight::CostType> Graph<dir, Wei, Adj>::MinCostMaxFlowCostScaling(
+    Vertex source, Vertex destination) const {
+  using Cap = typename Weight::CapacityType;
+  using Cost = typename Weight::CostType;
+  using Price = std::common_type_t<Cost, long long>;
+  static_assert(std::is_integral_v<Cost>, "cost scaling needs integral costs");
+  static_assert(std::is_signed_v<Cap>, "cost scaling needs signed capacities");
+  detail::ResidualNetwork<Cap> net(adj_list_, [](const auto& edge) { return edge.weight.capacity; });
+  Cap flow = detail::Dinic<Cap>(net).Run(source, destination);
+  std::vector<Price> cost = detail::ArcCosts<Price>(adj_list_, net);
+  detail::CostScaling(net, cost);
+
+  Cost total_cost{};
+  for (size_t arc : net.forward) {
+    total_cost += static_cast<Cost>(cost[arc] * net.residual[net.reverse[arc]]);
+  }
+  return {flow, total_cost};
 }
 
 #endif
\ No newline at end of file
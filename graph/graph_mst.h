@@ -2,84 +2,182 @@
 #define GRAPH_MST_H_
 
 #include "./_graph_class.h"
+#include "./_graph_parallel.h"
+#include "./_graph_sort.h"
 #include <algorithm>
+#include <atomic>
 #include <optional>
 #include <limits>
-#include <queue>
+#include <type_traits>
 #include "../other/disjoint_set_union.h"
 
 namespace detail {
+// Filter-Kruskal on [begin, end): edges lighter than a pivot are handled
+// first, then the heavier ones that already lie inside one component are
+// dropped before they are ever sorted
 template <class Weight>
-struct Comparator {
-  bool operator()(const Edge<Weight>& first, const Edge<Weight>& second) const noexcept {
-    return first.weight > second.weight ? true : first.dst > second.dst;
+void FilterKruskal(Edge<Weight>* begin, Edge<Weight>* end, DSU& dsu, std::vector<Edge<Weight>>& answer) {
+  constexpr ptrdiff_t kSortSize = 256;
+  auto by_weight = [](const Edge<Weight>& lhs, const Edge<Weight>& rhs) { return lhs.weight < rhs.weight; };
+  while (begin != end && dsu.Count() > 1) {
+    Edge<Weight>* middle = end;
+    if (end - begin > kSortSize) {
+      // Median of three
+      Weight first = begin->weight;
+      Weight second = begin[(end - begin) / 2].weight;
+      Weight third = end[-1].weight;
+      Weight pivot = std::max(std::min(first, second), std::min(std::max(first, second), third));
+      middle = std::partition(begin, end, [&pivot](const Edge<Weight>& edge) { return edge.weight < pivot; });
+      if (middle == begin) {
+        middle = std::partition(begin, end, [&pivot](const Edge<Weight>& edge) { return !(pivot < edge.weight); });
+      }
+    }
+    if (middle == end) {
+      std::sort(begin, end, by_weight);
+      for (; begin != end; ++begin) {
+        if (dsu.Unite(begin->src, begin->dst)) {
+          answer.emplace_back(*begin);
+        }
+      }
+      return;
+    }
+    FilterKruskal(begin, middle, dsu, answer);
+    begin = middle;
+    end = std::partition(begin, end, [&dsu](const Edge<Weight>& edge) {
+      return dsu.FindSet(edge.src) != dsu.FindSet(edge.dst);
+    });
   }
-};
+}
 }  // namespace detail
 
-template <bool dir, class Wei>
-template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
-std::vector<Edge<Weight>> Graph<dir, Wei>::Prim() const {
-  std::vector<bool> in_mst(adj_list_.size(), false);
+// Minimum spanning forest, grown from every vertex not reached yet. The
+// queue is keyed by the lightest known edge into the tree. Decrease-key
+// queues (DAryHeap, PairingHeap) hold at most one entry per vertex; lazy
+// ones (LazyBinaryHeap) leave stale copies that are skipped once the
+// vertex is in the tree. Keys are not monotone, so RadixHeap and
+// DialQueue do not apply. The dense mode scans a key array instead,
+// O(V^2) in total but without any heap traffic.
+template <bool dir, class Wei, class Adj>
+template <template <class> class Queue, bool directed, class Weight, EnifUndirected<dir, directed>,
+          EnifWeighted<Wei, Weight>>
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::Prim(bool dense) const {
+  constexpr Vertex kNone = static_cast<Vertex>(-1);
+  const size_t num_vertices = adj_list_.size();
+  std::vector<bool> in_mst(num_vertices, false);
+  std::vector<Vertex> parent(num_vertices, kNone);
+  std::vector<Weight> key(num_vertices);
   std::vector<Edge<Weight>> answer;
-  answer.reserve(adj_list_.size() - 1);
-  size_t mst_size = 0;
-  std::priority_queue<Edge<Weight>, std::vector<Edge<Weight>>, detail::Comparator<Weight>> queue;
-
-  for (const auto& edge : adj_list_[0]) {
-    queue.emplace(edge.src, edge.dst, edge.weight);
-  }
-
-  in_mst[0] = true;
 
-  while (mst_size != adj_list_.size() - 1) {
-    Edge<Weight> curr = queue.top();
-    queue.pop();
-    while (in_mst[curr.dst]) {
-      curr = queue.top();
-      queue.pop();
+  auto add = [&](Vertex vertex, auto&& lower) {
+    in_mst[vertex] = true;
+    if (parent[vertex] != kNone) {
+      answer.emplace_back(parent[vertex], vertex, key[vertex]);
     }
-    answer.push_back(curr);
-    in_mst[curr.dst] = true;
-    ++mst_size;
+    for (const auto& edge : adj_list_[vertex]) {
+      if (!in_mst[edge.dst] && (parent[edge.dst] == kNone || edge.weight < key[edge.dst])) {
+        parent[edge.dst] = vertex;
+        key[edge.dst] = edge.weight;
+        lower(edge.dst);
+      }
+    }
+  };
 
-    for (const auto& edge : adj_list_[curr.dst]) {
-      queue.emplace(edge.src, edge.dst, edge.weight);
+  if (dense) {
+    for (Vertex root = 0; root < num_vertices; ++root) {
+      if (in_mst[root]) {
+        continue;
+      }
+      auto nothing = [](Vertex) {};
+      for (Vertex vertex = root; vertex != kNone;) {
+        add(vertex, nothing);
+        vertex = kNone;
+        for (Vertex other = root + 1; other < num_vertices; ++other) {
+          if (!in_mst[other] && parent[other] != kNone && (vertex == kNone || key[other] < key[vertex])) {
+            vertex = other;
+          }
+        }
+      }
     }
+    return answer;
   }
 
+  Queue<Weight> queue(num_vertices);
+  auto lower = [&](Vertex vertex) { queue.Push(vertex, key[vertex]); };
+  for (Vertex root = 0; root < num_vertices; ++root) {
+    if (in_mst[root]) {
+      continue;
+    }
+    add(root, lower);
+    while (!queue.Empty()) {
+      Vertex vertex = queue.ExtractMin().second;
+      if (!in_mst[vertex]) {
+        add(vertex, lower);
+      }
+    }
+  }
   return answer;
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
 template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
-std::vector<Edge<Weight>> Graph<dir, Wei>::Kruskal() const {
-  std::vector<Edge<Weight>> sorted_edges;
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::Kruskal() const {
+  std::vector<Edge<Weight>> sorted_edges = UndirectedEdges();
   std::vector<Edge<Weight>> answer;
-  answer.reserve(adj_list_.size() - 1);
-  for (const auto& curr_edges : adj_list_) {
-    for (const auto& edge : curr_edges) {
-      sorted_edges.emplace_back(edge);
-    }
-  }
   std::sort(sorted_edges.begin(), sorted_edges.end(),
             [](Edge<Weight>& lhs, Edge<Weight>& rhs) { return lhs.weight < rhs.weight; });
 
   DSU dsu(adj_list_.size());
 
   for (const auto& edge : sorted_edges) {
-    if (dsu.FindSet(edge.src) != dsu.FindSet(edge.dst)) {
+    if (dsu.Unite(edge.src, edge.dst)) {
       answer.emplace_back(edge);
-      dsu.Union(edge.src, edge.dst);
     }
   }
 
   return answer;
 }
 
-template <bool dir, class Wei>
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::FilterKruskal() const {
+  std::vector<Edge<Weight>> edges = UndirectedEdges();
+  std::vector<Edge<Weight>> answer;
+  DSU dsu(adj_list_.size());
+  detail::FilterKruskal(edges.data(), edges.data() + edges.size(), dsu, answer);
+  return answer;
+}
+
+// Integral weights are radix sorted, others merge sorted; the union-find
+// pass over the sorted edges stays sequential
+template <bool dir, class Wei, class Adj>
 template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
-std::vector<Edge<Weight>> Graph<dir, Wei>::Boruvka() const {
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::ParallelKruskal(size_t num_threads) const {
+  std::vector<Edge<Weight>> sorted_edges = UndirectedEdges();
+  if constexpr (std::is_integral_v<Weight>) {
+    detail::ParallelRadixSort(
+        sorted_edges, [](const Edge<Weight>& edge) { return edge.weight; }, num_threads);
+  } else {
+    detail::ParallelSort(
+        sorted_edges, [](const Edge<Weight>& lhs, const Edge<Weight>& rhs) { return lhs.weight < rhs.weight; },
+        num_threads);
+  }
+
+  std::vector<Edge<Weight>> answer;
+  DSU dsu(adj_list_.size());
+  for (const auto& edge : sorted_edges) {
+    if (dsu.Unite(edge.src, edge.dst)) {
+      answer.emplace_back(edge);
+      if (dsu.Count() == 1) {
+        break;
+      }
+    }
+  }
+  return answer;
+}
+
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::Boruvka() const {
   std::vector<Edge<Weight>> answer;
   answer.reserve(adj_list_.size() - 1);
   DSU dsu(adj_list_.size());
@@ -113,4 +211,162 @@ std::vector<Edge<Weight>> Graph<dir, Wei>::Boruvka() const {
   return answer;
 }
 
+// Boruvka over a flat edge array, one entry per undirected edge. Every
+// round each component takes its lightest edge by atomic min on (weight,
+// edge index), which is a strict order, so the chosen edges form a forest
+// apart from pairs of components that chose the same edge. The smaller
+// label of such a pair becomes the root, pointer jumping relabels every
+// component to its root, and edges that became internal are dropped.
+// Returns a minimum spanning forest.
+template <bool dir, class Wei, class Adj>
+template <bool directed, class Weight, EnifUndirected<dir, directed>, EnifWeighted<Wei, Weight>>
+std::vector<Edge<Weight>> Graph<dir, Wei, Adj>::ParallelBoruvka(size_t num_threads) const {
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  constexpr size_t kGrain = 4096ul;
+  std::vector<Edge<Weight>> edges = UndirectedEdges();
+  auto lighter = [&edges](size_t lhs, size_t rhs) {
+    return edges[lhs].weight < edges[rhs].weight || (!(edges[rhs].weight < edges[lhs].weight) && lhs < rhs);
+  };
+
+  // Live edges between current component labels
+  std::vector<Vertex> from(edges.size());
+  std::vector<Vertex> to(edges.size());
+  std::vector<size_t> id(edges.size());
+  for (size_t index = 0; index < edges.size(); ++index) {
+    from[index] = edges[index].src;
+    to[index] = edges[index].dst;
+    id[index] = index;
+  }
+  std::vector<Vertex> next_from(edges.size());
+  std::vector<Vertex> next_to(edges.size());
+  std::vector<size_t> next_id(edges.size());
+
+  detail::ThreadPool pool(std::max(num_threads, 1ul));
+  std::vector<Edge<Weight>> answer;
+  size_t num_components = adj_list_.size();
+  std::vector<std::atomic<size_t>> best(num_components);
+  std::vector<Vertex> parent(num_components);
+  std::vector<Vertex> jumped(num_components);
+  std::vector<size_t> chunk_count;
+  while (!id.empty()) {
+    pool.Run(num_components, [&](size_t, size_t begin, size_t end) {
+      for (Vertex comp = begin; comp < end; ++comp) {
+        best[comp].store(kNone, std::memory_order_relaxed);
+      }
+    });
+    pool.Run(id.size(), [&](size_t, size_t begin, size_t end) {
+      auto offer = [&](Vertex comp, size_t edge) {
+        size_t curr = best[comp].load(std::memory_order_relaxed);
+        while ((curr == kNone || lighter(edge, curr)) &&
+               !best[comp].compare_exchange_weak(curr, edge, std::memory_order_relaxed)) {
+        }
+      };
+      for (size_t index = begin; index < end; ++index) {
+        offer(from[index], id[index]);
+        offer(to[index], id[index]);
+      }
+    });
+
+    // Hook every component to the other side of its lightest edge
+    pool.Run(num_components, [&](size_t, size_t begin, size_t end) {
+      for (Vertex comp = begin; comp < end; ++comp) {
+        parent[comp] = comp;
+      }
+    });
+    pool.Run(id.size(), [&](size_t, size_t begin, size_t end) {
+      for (size_t index = begin; index < end; ++index) {
+        if (best[from[index]].load(std::memory_order_relaxed) == id[index]) {
+          parent[from[index]] = to[index];
+        }
+        if (best[to[index]].load(std::memory_order_relaxed) == id[index]) {
+          parent[to[index]] = from[index];
+        }
+      }
+    });
+    // Mutual choices are the only cycles: the smaller label stays a root,
+    // every other hook contributes its edge exactly once
+    for (Vertex comp = 0; comp < num_components; ++comp) {
+      Vertex other = parent[comp];
+      if (other == comp || (parent[other] == comp && comp < other)) {
+        jumped[comp] = comp;
+      } else {
+        jumped[comp] = other;
+        answer.emplace_back(edges[best[comp].load(std::memory_order_relaxed)]);
+      }
+    }
+    parent.swap(jumped);
+
+    for (bool changed = true; changed;) {
+      std::atomic<bool> any{false};
+      pool.Run(num_components, [&](size_t, size_t begin, size_t end) {
+        bool local = false;
+        for (Vertex comp = begin; comp < end; ++comp) {
+          jumped[comp] = parent[parent[comp]];
+          local |= jumped[comp] != parent[comp];
+        }
+        if (local) {
+          any.store(true, std::memory_order_relaxed);
+        }
+      });
+      parent.swap(jumped);
+      changed = any.load();
+    }
+
+    // Roots get consecutive labels
+    size_t num_roots = 0ul;
+    for (Vertex comp = 0; comp < num_components; ++comp) {
+      if (parent[comp] == comp) {
+        jumped[comp] = num_roots++;
+      }
+    }
+    pool.Run(num_components, [&](size_t, size_t begin, size_t end) {
+      for (Vertex comp = begin; comp < end; ++comp) {
+        parent[comp] = jumped[parent[comp]];
+      }
+    });
+
+    // Relabel and drop self-loops: count per chunk, then scatter
+    size_t num_chunks = (id.size() + kGrain - 1) / kGrain;
+    chunk_count.assign(num_chunks + 1, 0ul);
+    pool.Run(
+        id.size(),
+        [&](size_t, size_t begin, size_t end) {
+          size_t kept = 0ul;
+          for (size_t index = begin; index < end; ++index) {
+            from[index] = parent[from[index]];
+            to[index] = parent[to[index]];
+            kept += from[index] != to[index];
+          }
+          chunk_count[begin / kGrain + 1] = kept;
+        },
+        kGrain);
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+      chunk_count[chunk + 1] += chunk_count[chunk];
+    }
+    size_t num_live = chunk_count[num_chunks];
+    next_from.resize(num_live);
+    next_to.resize(num_live);
+    next_id.resize(num_live);
+    pool.Run(
+        id.size(),
+        [&](size_t, size_t begin, size_t end) {
+          size_t out = chunk_count[begin / kGrain];
+          for (size_t index = begin; index < end; ++index) {
+            if (from[index] != to[index]) {
+              next_from[out] = from[index];
+              next_to[out] = to[index];
+              next_id[out] = id[index];
+              ++out;
+            }
+          }
+        },
+        kGrain);
+    from.swap(next_from);
+    to.swap(next_to);
+    id.swap(next_id);
+    num_components = num_roots;
+  }
+  return answer;
+}
+
 #endif
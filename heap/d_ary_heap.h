@@ -0,0 +1,141 @@
+#ifndef D_ARY_HEAP_H_
+#define D_ARY_HEAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Indexed d-ary min-heap over ids in [0, capacity).
+// Every id is stored at most once: Push inserts a new id or decreases
+// the key of an id that is already in the heap.
+template <class Key, size_t arity = 4ul>
+class DAryHeap {
+  static_assert(arity >= 2ul, "DAryHeap needs at least two children per node");
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+ private:
+  std::vector<size_t> heap_;
+  std::vector<size_t> position_;
+  std::vector<Key> key_;
+
+ public:
+  DAryHeap() = default;
+  explicit DAryHeap(size_t);
+
+  bool Empty() const;
+  size_t Size() const;
+  bool Contains(size_t) const;
+  const Key& GetKey(size_t) const;
+  void Clear();
+  void Push(size_t, const Key&);
+  std::pair<Key, size_t> ExtractMin();
+
+ private:
+  void SiftUp(size_t);
+  void SiftDown(size_t);
+};
+
+template <class Key>
+using QuaternaryHeap = DAryHeap<Key, 4ul>;
+
+template <class Key, size_t arity>
+DAryHeap<Key, arity>::DAryHeap(size_t capacity) : heap_{}, position_(capacity, kNone), key_(capacity) {
+}
+
+template <class Key, size_t arity>
+bool DAryHeap<Key, arity>::Empty() const {
+  return heap_.empty();
+}
+
+template <class Key, size_t arity>
+size_t DAryHeap<Key, arity>::Size() const {
+  return heap_.size();
+}
+
+template <class Key, size_t arity>
+bool DAryHeap<Key, arity>::Contains(size_t id) const {
+  return position_[id] != kNone;
+}
+
+template <class Key, size_t arity>
+const Key& DAryHeap<Key, arity>::GetKey(size_t id) const {
+  return key_[id];
+}
+
+template <class Key, size_t arity>
+void DAryHeap<Key, arity>::Clear() {
+  for (size_t id : heap_) {
+    position_[id] = kNone;
+  }
+  heap_.clear();
+}
+
+template <class Key, size_t arity>
+void DAryHeap<Key, arity>::Push(size_t id, const Key& key) {
+  if (position_[id] == kNone) {
+    position_[id] = heap_.size();
+    heap_.emplace_back(id);
+  } else if (!(key < key_[id])) {
+    return;
+  }
+  key_[id] = key;
+  SiftUp(position_[id]);
+}
+
+template <class Key, size_t arity>
+std::pair<Key, size_t> DAryHeap<Key, arity>::ExtractMin() {
+  size_t id = heap_[0];
+  position_[id] = kNone;
+  size_t last = heap_.back();
+  heap_.pop_back();
+  if (!heap_.empty()) {
+    heap_[0] = last;
+    position_[last] = 0ul;
+    SiftDown(0ul);
+  }
+  return {key_[id], id};
+}
+
+template <class Key, size_t arity>
+void DAryHeap<Key, arity>::SiftUp(size_t index) {
+  size_t id = heap_[index];
+  while (index) {
+    size_t parent = (index - 1) / arity;
+    if (!(key_[id] < key_[heap_[parent]])) {
+      break;
+    }
+    heap_[index] = heap_[parent];
+    position_[heap_[index]] = index;
+    index = parent;
+  }
+  heap_[index] = id;
+  position_[id] = index;
+}
+
+template <class Key, size_t arity>
+void DAryHeap<Key, arity>::SiftDown(size_t index) {
+  size_t id = heap_[index];
+  while (true) {
+    size_t first = index * arity + 1;
+    if (first >= heap_.size()) {
+      break;
+    }
+    size_t last = first + arity < heap_.size() ? first + arity : heap_.size();
+    size_t smallest = first;
+    for (size_t child = first + 1; child < last; ++child) {
+      if (key_[heap_[child]] < key_[heap_[smallest]]) {
+        smallest = child;
+      }
+    }
+    if (!(key_[heap_[smallest]] < key_[id])) {
+      break;
+    }
+    heap_[index] = heap_[smallest];
+    position_[heap_[index]] = index;
+    index = smallest;
+  }
+  heap_[index] = id;
+  position_[id] = index;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef DIAL_QUEUE_H_
+#define DIAL_QUEUE_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Dial's bucket queue for monotone non-negative integer keys: every
+// pushed key must be at least the last extracted one. Keys within the
+// span of the last extracted key map to a circular array of buckets, one
+// key per bucket. The buckets are singly linked lists through one pooled
+// entry buffer whose freed entries are reused, so pushes do not allocate
+// once the pool has grown. A key beyond the span doubles the bucket
+// array. Like RadixHeap it has no decrease-key, stale entries are skipped
+// by the caller.
+template <class Key>
+class DialQueue {
+  static_assert(std::is_integral_v<Key>, "DialQueue requires integer keys");
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  struct Entry {
+    Key key;
+    size_t id;
+    size_t next;
+  };
+
+ private:
+  std::vector<Entry> pool_;
+  std::vector<size_t> head_;  // first entry of every bucket, size is a power of two
+  size_t free_{kNone};
+  Key current_{0};
+  size_t size_{0ul};
+
+ public:
+  DialQueue();
+  // span: largest expected distance between a pushed and the minimum key
+  explicit DialQueue(size_t, size_t span = 1ul);
+
+  bool Empty() const;
+  size_t Size() const;
+  void Clear();
+  void Push(size_t, const Key&);
+  std::pair<Key, size_t> ExtractMin();
+
+ private:
+  void Grow(size_t);
+};
+
+template <class Key>
+DialQueue<Key>::DialQueue() : head_(2ul, kNone) {
+}
+
+template <class Key>
+DialQueue<Key>::DialQueue(size_t capacity, size_t span) : head_(2ul, kNone) {
+  pool_.reserve(capacity);
+  Grow(span);
+}
+
+template <class Key>
+bool DialQueue<Key>::Empty() const {
+  return size_ == 0ul;
+}
+
+template <class Key>
+size_t DialQueue<Key>::Size() const {
+  return size_;
+}
+
+template <class Key>
+void DialQueue<Key>::Clear() {
+  pool_.clear();
+  std::fill(head_.begin(), head_.end(), kNone);
+  free_ = kNone;
+  current_ = 0;
+  size_ = 0ul;
+}
+
+template <class Key>
+void DialQueue<Key>::Push(size_t id, const Key& key) {
+  if (static_cast<size_t>(key - current_) >= head_.size()) {
+    Grow(static_cast<size_t>(key - current_));
+  }
+  size_t entry = free_;
+  if (entry == kNone) {
+    entry = pool_.size();
+    pool_.push_back({key, id, kNone});
+  } else {
+    free_ = pool_[entry].next;
+    pool_[entry].key = key;
+    pool_[entry].id = id;
+  }
+  size_t& head = head_[static_cast<size_t>(key) & (head_.size() - 1)];
+  pool_[entry].next = head;
+  head = entry;
+  ++size_;
+}
+
+template <class Key>
+std::pair<Key, size_t> DialQueue<Key>::ExtractMin() {
+  const size_t mask = head_.size() - 1;
+  while (head_[static_cast<size_t>(current_) & mask] == kNone) {
+    ++current_;
+  }
+  size_t& head = head_[static_cast<size_t>(current_) & mask];
+  size_t entry = head;
+  head = pool_[entry].next;
+  pool_[entry].next = free_;
+  free_ = entry;
+  --size_;
+  return {current_, pool_[entry].id};
+}
+
+// Rehangs every entry into a bucket array covering at least `span` keys
+// past the current minimum
+template <class Key>
+void DialQueue<Key>::Grow(size_t span) {
+  size_t num_buckets = head_.size();
+  while (num_buckets <= span) {
+    num_buckets *= 2;
+  }
+  if (num_buckets == head_.size()) {
+    return;
+  }
+  std::vector<size_t> head(num_buckets, kNone);
+  for (size_t bucket : head_) {
+    while (bucket != kNone) {
+      size_t next = pool_[bucket].next;
+      size_t& target = head[static_cast<size_t>(pool_[bucket].key) & (num_buckets - 1)];
+      pool_[bucket].next = target;
+      target = bucket;
+      bucket = next;
+    }
+  }
+  head_.swap(head);
+}
+
+#endif
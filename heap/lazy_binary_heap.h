@@ -0,0 +1,63 @@
+#ifndef LAZY_BINARY_HEAP_H_
+#define LAZY_BINARY_HEAP_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Addressable-by-id priority queue without decrease-key: Push always
+// inserts a new (key, id) entry and outdated entries are left in place.
+// ExtractMin may therefore return an id more than once, the caller skips
+// the stale copies.
+template <class Key>
+class LazyBinaryHeap {
+ private:
+  std::vector<std::pair<Key, size_t>> array_;
+
+ public:
+  LazyBinaryHeap() = default;
+  explicit LazyBinaryHeap(size_t);
+
+  bool Empty() const;
+  size_t Size() const;
+  void Clear();
+  void Push(size_t, const Key&);
+  std::pair<Key, size_t> ExtractMin();
+};
+
+template <class Key>
+LazyBinaryHeap<Key>::LazyBinaryHeap(size_t) : array_{} {
+}
+
+template <class Key>
+bool LazyBinaryHeap<Key>::Empty() const {
+  return array_.empty();
+}
+
+template <class Key>
+size_t LazyBinaryHeap<Key>::Size() const {
+  return array_.size();
+}
+
+template <class Key>
+void LazyBinaryHeap<Key>::Clear() {
+  array_.clear();
+}
+
+template <class Key>
+void LazyBinaryHeap<Key>::Push(size_t id, const Key& key) {
+  array_.emplace_back(key, id);
+  std::push_heap(array_.begin(), array_.end(), std::greater<>{});
+}
+
+template <class Key>
+std::pair<Key, size_t> LazyBinaryHeap<Key>::ExtractMin() {
+  std::pop_heap(array_.begin(), array_.end(), std::greater<>{});
+  auto value = std::move(array_.back());
+  array_.pop_back();
+  return value;
+}
+
+#endif
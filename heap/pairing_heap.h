@@ -0,0 +1,161 @@
+#ifndef PAIRING_HEAP_H_
+#define PAIRING_HEAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Indexed pairing min-heap over ids in [0, capacity).
+// Nodes live in flat arrays indexed by id, so there is no per-node
+// allocation. Push inserts a new id or decreases the key of a stored one.
+template <class Key>
+class PairingHeap {
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+ private:
+  std::vector<Key> key_;
+  std::vector<size_t> child_;
+  std::vector<size_t> sibling_;
+  std::vector<size_t> prev_;  // left sibling, or parent for the leftmost child
+  std::vector<bool> in_heap_;
+  std::vector<size_t> scratch_;
+  size_t root_{kNone};
+  size_t size_{0ul};
+
+ public:
+  PairingHeap() = default;
+  explicit PairingHeap(size_t);
+
+  bool Empty() const;
+  size_t Size() const;
+  bool Contains(size_t) const;
+  void Clear();
+  void Push(size_t, const Key&);
+  std::pair<Key, size_t> ExtractMin();
+
+ private:
+  size_t Meld(size_t, size_t);
+  void Cut(size_t);
+};
+
+template <class Key>
+PairingHeap<Key>::PairingHeap(size_t capacity)
+    : key_(capacity)
+    , child_(capacity, kNone)
+    , sibling_(capacity, kNone)
+    , prev_(capacity, kNone)
+    , in_heap_(capacity, false)
+    , scratch_{} {
+}
+
+template <class Key>
+bool PairingHeap<Key>::Empty() const {
+  return root_ == kNone;
+}
+
+template <class Key>
+size_t PairingHeap<Key>::Size() const {
+  return size_;
+}
+
+template <class Key>
+bool PairingHeap<Key>::Contains(size_t id) const {
+  return in_heap_[id];
+}
+
+template <class Key>
+void PairingHeap<Key>::Clear() {
+  scratch_.clear();
+  if (root_ != kNone) {
+    scratch_.emplace_back(root_);
+  }
+  while (!scratch_.empty()) {
+    size_t node = scratch_.back();
+    scratch_.pop_back();
+    for (size_t child = child_[node]; child != kNone; child = sibling_[child]) {
+      scratch_.emplace_back(child);
+    }
+    child_[node] = sibling_[node] = prev_[node] = kNone;
+    in_heap_[node] = false;
+  }
+  root_ = kNone;
+  size_ = 0ul;
+}
+
+template <class Key>
+void PairingHeap<Key>::Push(size_t id, const Key& key) {
+  if (!in_heap_[id]) {
+    in_heap_[id] = true;
+    ++size_;
+    key_[id] = key;
+    root_ = root_ == kNone ? id : Meld(root_, id);
+    return;
+  }
+  if (!(key < key_[id])) {
+    return;
+  }
+  key_[id] = key;
+  if (id != root_) {
+    Cut(id);
+    root_ = Meld(root_, id);
+  }
+}
+
+template <class Key>
+std::pair<Key, size_t> PairingHeap<Key>::ExtractMin() {
+  size_t min = root_;
+  in_heap_[min] = false;
+  --size_;
+
+  // First pass: meld children pairwise from left to right
+  scratch_.clear();
+  size_t child = std::exchange(child_[min], kNone);
+  while (child != kNone) {
+    size_t first = child;
+    size_t second = sibling_[first];
+    child = second == kNone ? kNone : sibling_[second];
+    sibling_[first] = prev_[first] = kNone;
+    if (second != kNone) {
+      sibling_[second] = prev_[second] = kNone;
+      first = Meld(first, second);
+    }
+    scratch_.emplace_back(first);
+  }
+  // Second pass: meld the pairs from right to left
+  root_ = kNone;
+  while (!scratch_.empty()) {
+    root_ = root_ == kNone ? scratch_.back() : Meld(scratch_.back(), root_);
+    scratch_.pop_back();
+  }
+  return {key_[min], min};
+}
+
+template <class Key>
+size_t PairingHeap<Key>::Meld(size_t lhs, size_t rhs) {
+  if (key_[rhs] < key_[lhs]) {
+    std::swap(lhs, rhs);
+  }
+  sibling_[rhs] = child_[lhs];
+  if (child_[lhs] != kNone) {
+    prev_[child_[lhs]] = rhs;
+  }
+  prev_[rhs] = lhs;
+  child_[lhs] = rhs;
+  return lhs;
+}
+
+template <class Key>
+void PairingHeap<Key>::Cut(size_t node) {
+  size_t prev = prev_[node];
+  if (child_[prev] == node) {
+    child_[prev] = sibling_[node];
+  } else {
+    sibling_[prev] = sibling_[node];
+  }
+  if (sibling_[node] != kNone) {
+    prev_[sibling_[node]] = prev;
+  }
+  sibling_[node] = prev_[node] = kNone;
+}
+
+#endif
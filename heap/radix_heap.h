@@ -0,0 +1,105 @@
+#ifndef RADIX_HEAP_H_
+#define RADIX_HEAP_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Monotone radix heap for non-negative integer keys: every pushed key
+// must be at least the last extracted one, which always holds for
+// Dijkstra with non-negative weights. Bucket i keeps the keys whose
+// highest bit differing from the last extracted key is bit i - 1.
+// Like LazyBinaryHeap it has no decrease-key, stale entries are skipped
+// by the caller.
+template <class Key>
+class RadixHeap {
+  static_assert(std::is_integral_v<Key>, "RadixHeap requires integer keys");
+  using Unsigned = std::make_unsigned_t<Key>;
+  static constexpr size_t kNumBuckets = 8ul * sizeof(Unsigned) + 1ul;
+
+ private:
+  std::vector<std::vector<std::pair<Unsigned, size_t>>> buckets_;
+  Unsigned last_{0};
+  size_t size_{0ul};
+
+ public:
+  RadixHeap();
+  explicit RadixHeap(size_t);
+
+  bool Empty() const;
+  size_t Size() const;
+  void Clear();
+  void Push(size_t, const Key&);
+  std::pair<Key, size_t> ExtractMin();
+
+ private:
+  size_t Bucket(Unsigned) const;
+};
+
+template <class Key>
+RadixHeap<Key>::RadixHeap() : buckets_(kNumBuckets) {
+}
+
+template <class Key>
+RadixHeap<Key>::RadixHeap(size_t) : buckets_(kNumBuckets) {
+}
+
+template <class Key>
+bool RadixHeap<Key>::Empty() const {
+  return size_ == 0ul;
+}
+
+template <class Key>
+size_t RadixHeap<Key>::Size() const {
+  return size_;
+}
+
+template <class Key>
+void RadixHeap<Key>::Clear() {
+  for (auto& bucket : buckets_) {
+    bucket.clear();
+  }
+  last_ = 0;
+  size_ = 0ul;
+}
+
+template <class Key>
+void RadixHeap<Key>::Push(size_t id, const Key& key) {
+  auto value = static_cast<Unsigned>(key);
+  buckets_[Bucket(value)].emplace_back(value, id);
+  ++size_;
+}
+
+template <class Key>
+std::pair<Key, size_t> RadixHeap<Key>::ExtractMin() {
+  if (buckets_[0].empty()) {
+    size_t index = 1;
+    while (buckets_[index].empty()) {
+      ++index;
+    }
+    auto& bucket = buckets_[index];
+    last_ = bucket[0].first;
+    for (const auto& entry : bucket) {
+      if (entry.first < last_) {
+        last_ = entry.first;
+      }
+    }
+    for (const auto& entry : bucket) {
+      buckets_[Bucket(entry.first)].emplace_back(entry);
+    }
+    bucket.clear();
+  }
+  size_t id = buckets_[0].back().second;
+  buckets_[0].pop_back();
+  --size_;
+  return {static_cast<Key>(last_), id};
+}
+
+template <class Key>
+size_t RadixHeap<Key>::Bucket(Unsigned value) const {
+  auto diff = static_cast<unsigned long long>(value ^ last_);
+  return diff ? 8ul * sizeof(unsigned long long) - __builtin_clzll(diff) : 0ul;
+}
+
+#endif
@@ -19,6 +19,8 @@ class DSU {
   void MakeSet();
   size_t FindSet(size_t) noexcept;
   void Union(size_t, size_t) noexcept;
+  // Union that reports whether the sets were different
+  bool Unite(size_t, size_t) noexcept;
 };
 
 DSU::DSU(size_t n) : parent_(n), rank_(n, 0ul), count_{n} {
@@ -37,22 +39,23 @@ void DSU::MakeSet() {
   ++count_;
 }
 
+// Path halving: one pass, every other node skips to its grandparent
 size_t DSU::FindSet(size_t x) noexcept {
-  size_t root = parent_[x];
-  while (root != parent_[root]) {
-    root = parent_[root];
+  while (x != parent_[x]) {
+    x = parent_[x] = parent_[parent_[x]];
   }
-  while (x != root) {
-    x = std::exchange(parent_[x], root);
-  }
-  return root;
+  return x;
 }
 
 void DSU::Union(size_t x, size_t y) noexcept {
+  Unite(x, y);
+}
+
+bool DSU::Unite(size_t x, size_t y) noexcept {
   x = FindSet(x);
   y = FindSet(y);
   if (x == y) {
-    return;
+    return false;
   }
   --count_;
   if (rank_[x] < rank_[y]) {
@@ -63,6 +66,7 @@ void DSU::Union(size_t x, size_t y) noexcept {
     parent_[x] = y;
     ++rank_[y];
   }
+  return true;
 }
 
 #endif
\ No newline at end of file